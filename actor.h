@@ -3,6 +3,7 @@
 
 #include"point.h"
 #include<string>
+#include<ostream>
 
 // An Actor can have certain States that describe 
 // What they are doing
@@ -21,7 +22,7 @@ public:
 	// Pure virtual functions: Actor is an ABC
 	// Derived classes must implement
 	virtual	void	update() = 0;
-	virtual	void	say() = 0;
+	virtual	void	say(std::ostream& os) = 0;
 
 	// Maybe overriden in derived class
 	// Otherwise just returns the char
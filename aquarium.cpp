@@ -1,192 +1,440 @@
 #include"aquarium.h"
 #include"player.h"
-#include"shark.h"
 #include"utils.h"
+#include"mazefile.h"
+#include"threadpool.h"
+#include"parallelbfs.h"
 #include<iostream>
-#include <fstream>
-#include <iterator>
+#include<sstream>
 #include<string>
-#include <chrono>
+#include<cstring>
+#include <cstdint>
+
+// Alignment of the grid block, one cache line
+static const int GRID_ALIGN = 64;
+
+Aquarium::Aquarium() :
+	m_openCells(), m_openCellsBuilt(false), m_nOpen(0),
+	m_openMask(nullptr), m_openBits(), m_field(), m_gridBlock(nullptr), m_player(nullptr), m_actors(), m_nActors(0), m_sharks(), m_rng(), m_pool(nullptr), m_component(nullptr), m_componentSize(),
+	m_spawnCells(), m_spawnCellsBuilt(false), m_occupancy(nullptr),
+	m_metrics() {
+}
+
 // Create the aquarium from file
-Aquarium::Aquarium(std::string filename) :
-	m_openCells(), m_nActors(0), m_duration(0) {
+Aquarium::Aquarium(std::string filename) :Aquarium() {
+	std::string error;
+	if (!loadFile(filename, error)) {
+		std::cerr << "ERROR Aquarium: " << error << ". Exiting." << std::endl;
+		exit(1);
+	}
 
-	std::fstream file(filename);
+	setup();
+}
 
-	//assert(file.is_open());
-	if (!file.is_open()) {
-		std::cerr << "ERROR Aquarium: could not open file " << filename << ". Exiting." << std::endl;
+// Create the aquarium from maze text already in memory
+Aquarium::Aquarium(const char* text, size_t size) :Aquarium() {
+	std::string error;
+	if (!load(text, size, error)) {
+		std::cerr << "ERROR Aquarium: maze text: " << error << ". Exiting." << std::endl;
 		exit(1);
 	}
-	int col = 0, row = 0;
-	// Count rows and columns in file
-	for (std::istreambuf_iterator<char> iter(file), e; iter != e; ++iter) {
-		char c = *iter;
-		if (!(c == '\n' || c == '\r'))
-			col++;
-		if (c == '\n') {
-			row++;
-		}
 
+	setup();
+}
+
+Aquarium* Aquarium::create(const std::string& filename, std::string& error) {
+	Aquarium* aquarium = new Aquarium();
+	if (!aquarium->loadFile(filename, error)) {
+		delete aquarium;
+		return nullptr;
 	}
-	// columns count occured row-times, divide out
-	m_cols = (int)(col / row);
-	m_rows = row;
-
-	// Allocate the aquarium 
-	m_aquarium = new char* [m_cols];
-	m_renderedAquarium = new char* [m_cols];
-	for (int i = 0; i < m_cols; i++) {
-		m_aquarium[i] = new char[m_rows];
-		m_renderedAquarium[i] = new char[m_rows];
-	}
-	int x = 0, y = 0;
-	// Reset file 
-	file.clear();
-	file.seekg(0, std::ios::beg);
-	// Fill in the aquarium
-	for (std::istreambuf_iterator<char> iter(file), e; iter != e; ++iter) {
-		char c = *iter;
-		if (!(c == '\n' || c == '\r')) {
-			m_aquarium[(x++) % m_cols][y] = c;
-		}
-		if (c == '\n') {
-			y++;
-		}
+	aquarium->setup();
+	return aquarium;
+}
+
+Aquarium* Aquarium::create(const char* text, size_t size, std::string& error) {
+	Aquarium* aquarium = new Aquarium();
+	if (!aquarium->load(text, size, error)) {
+		error = "maze text: " + error;
+		delete aquarium;
+		return nullptr;
 	}
-	file.close();
-	// Store number of free cells
-	for (int y = 0; y < m_rows; y++) {
-		for (int x = 0; x < m_cols; x++) {
-			if (m_aquarium[x][y] != 'X' && m_aquarium[x][y] != 'S')
-				m_openCells.push_front(Point(x, y));
-			if (m_aquarium[x][y] == 'S') {
-				m_aquarium[x][y] = ' ';
+	aquarium->setup();
+	return aquarium;
+}
+
+bool Aquarium::loadFile(const std::string& filename, std::string& error) {
+	MappedFile file;
+	if (!file.open(filename)) {
+		error = "could not open file " + filename;
+		return false;
+	}
+	if (!load(file.data(), file.size(), error)) {
+		error = filename + ": " + error;
+		return false;
+	}
+	return true;
+}
+
+// Everything after the maze is loaded, shared by the constructors
+void Aquarium::setup() {
+	m_occupancy = new int[m_rows * m_cols]();
+	m_openBits.assign(m_openMask, m_rows, m_cols);
+	labelComponents();
+
+	seed(Rng::entropySeed());
+
+	m_player = new Player(this, m_start, "Nemo", '@');
+	// 0th actor Polymorphic handle to player
+	m_actors.push(m_player);
+	m_nActors++;
+}
+
+// Parse the maze text in a single pass.  The first line fixes the 
+// width, every other line must match it.  Lines may end in "\n" or 
+// "\r\n" and the last line may leave off its newline.  Each row is
+// copied into the grid and classified into the open cell mask as it
+// goes, only rows holding 'S' or 'E' need a second look.
+bool Aquarium::load(const char* text, size_t size, std::string& error) {
+	const char* end = text + size;
+
+	const char* eol = findNewline(text, end);
+	int width = (int)(eol - text);
+	if (width > 0 && text[width - 1] == '\r')
+		width--;
+	if (width == 0) {
+		error = "maze is empty";
+		return false;
+	}
+
+	// Every row takes at least width + 1 bytes, except maybe the last
+	int maxRows = (int)(size / (width + 1)) + 1;
+	m_cols = width;
+	allocateGrids(maxRows);
+
+	bool haveStart = false, haveEnd = false;
+	int y = 0;
+	const char* p = text;
+	while (p < end) {
+		char* cells = m_aquarium.row(y);
+		bool* open = m_openMask + (size_t)y * m_cols;
+
+		if (end - p < width) {
+			error = "row " + std::to_string(y + 1) + " is shorter than the first row";
+			return false;
+		}
+		int x = scanRow(p, width, cells, open, m_nOpen);
+		for (; x < width; x++) {
+			switch (cells[x]) {
+			case 'X':
+			case ' ':
+				break;
+			case 'E':
+				if (haveEnd) {
+					error = "more than one exit 'E'";
+					return false;
+				}
+				haveEnd = true;
+				cells[x] = ' ';
+				open[x] = true;
+				m_nOpen++;
+				m_end.set(x, y);
+				break;
+			case 'S':
+				if (haveStart) {
+					error = "more than one start 'S'";
+					return false;
+				}
+				// The start is not counted as an open cell
+				haveStart = true;
+				cells[x] = ' ';
 				m_start.set(x, y);
+				break;
+			case '\n':
+			case '\r':
+				error = "row " + std::to_string(y + 1) + " is shorter than the first row";
+				return false;
+			default:
+				error = std::string("unexpected character '") + cells[x] + "' in row "
+					+ std::to_string(y + 1) + ", expected one of 'X', ' ', 'S', 'E'";
+				return false;
 			}
-			if (m_aquarium[x][y] == 'E') {
-				m_aquarium[x][y] = ' ';
-				m_end.set(x, y);
+		}
+		p += width;
+		y++;
+
+		// Row terminator, or the end of a file without a final newline
+		if (p < end && *p == '\r')
+			p++;
+		if (p < end) {
+			if (*p != '\n') {
+				error = "row " + std::to_string(y) + " is longer than the first row";
+				return false;
 			}
+			p++;
 		}
 	}
 
-	m_player = new Player(this, m_start, "Nemo", '@');
-	// 0th actor Polymorphic handle to player
-	m_actors[m_nActors++] = m_player;
+	if (!haveStart) {
+		error = "no start 'S'";
+		return false;
+	}
+	if (!haveEnd) {
+		error = "no exit 'E'";
+		return false;
+	}
+
+	m_rows = y;
+	m_aquarium = Grid(m_aquarium.data(), m_rows, m_cols);
+	m_renderedAquarium = Grid(m_renderedAquarium.data(), m_rows, m_cols);
+	return true;
 }
 
-Aquarium::~Aquarium() {
-	for (int i = 0; i < m_cols; i++) {
-		delete[] m_renderedAquarium[i];
-		delete[] m_aquarium[i];
+// Allocate the aquarium and its rendered copy as one block, each
+// grid starting on its own cache line, plus the open cell mask.
+// Over allocate by one line so the start of the block can be rounded
+// up.  Sized for maxRows, load() trims the views to the rows it finds.
+void Aquarium::allocateGrids(int maxRows) {
+	size_t cells = (size_t)maxRows * m_cols;
+	size_t stride = (cells + GRID_ALIGN - 1) / GRID_ALIGN * GRID_ALIGN;
+	m_gridBlock = new char[2 * stride + GRID_ALIGN];
+	uintptr_t base = reinterpret_cast<uintptr_t>(m_gridBlock);
+	char* aligned = m_gridBlock + ((GRID_ALIGN - base % GRID_ALIGN) % GRID_ALIGN);
+	m_aquarium = Grid(aligned, maxRows, m_cols);
+	m_renderedAquarium = Grid(aligned + stride, maxRows, m_cols);
 
-	}
-	delete[] m_aquarium;
+	// Padded for the shark kernel's wide loads
+	m_openMask = new bool[cells + SHARK_MASK_PAD]();
+}
 
-	delete[] m_renderedAquarium;
+Aquarium::~Aquarium() {
+	delete[] m_gridBlock;
+	delete[] m_openMask;
+	delete[] m_occupancy;
+	delete[] m_component;
+	delete m_pool;
 
 	for (int i = 0; i < m_nActors; i++) {
 		delete m_actors[i];
 	}
 }
 
+// Stream ids of the aquarium seed
+static const uint64_t SHARK_MOVE_STREAM = 1;
+
+void Aquarium::seed(uint64_t seed) {
+	m_rng.seed(seed);
+	m_sharks.setSeed(m_rng.stream(SHARK_MOVE_STREAM).nextU32());
+}
+
+void Aquarium::setThreads(int threads) {
+	delete m_pool;
+	m_pool = nullptr;
+	if (threads != 1)
+		m_pool = new ThreadPool(threads);
+}
+
 void Aquarium::setPlayerBackTracking(bool toggle) {
 	if (m_player != nullptr) m_player->toggleBackTrack(toggle);
 }
 
+void Aquarium::setPlayerSearch(SearchKind kind) {
+	if (m_player != nullptr) m_player->setSearch(kind);
+}
+
 void Aquarium::update() {
 
-	auto t1 = std::chrono::high_resolution_clock::now();
-	m_actors[0]->update();
-	auto t2 = std::chrono::high_resolution_clock::now();
-	m_duration += std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+	{
+		PhaseTimer timer(m_metrics, Phase::PLAYER_UPDATE);
+		m_actors[0]->update();
+	}
 
+	PhaseTimer timer(m_metrics, Phase::SHARK_UPDATE);
 	for (int i = 1; i < m_nActors; i++) {
 		m_actors[i]->update();
 	}
+	m_sharks.update(m_openMask, m_rows, m_cols, m_pool);
 }
 
 double Aquarium::getPlayerUpdateRunTime() {
-	return m_duration;
+	return (double)m_metrics.phase(Phase::PLAYER_UPDATE).total();
+}
+Metrics& Aquarium::metrics() {
+	return m_metrics;
 }
+const Metrics& Aquarium::metrics() const {
+	return m_metrics;
+}
+//  interact()
+//		Actors interact with whoever shares their cell.  Instead of
+//		comparing every pair, count the actors in each occupied cell
+//		then read every actor's count back, O(actors) per step.
+//
+//		Nemo (actor 0) sharing a cell with anything is an ATTACK for
+//		everyone in that cell, attacking takes precedence over greeting.
+//		Sharks sharing a cell without Nemo GREET, everyone else is ALONE.
 void Aquarium::interact() {
+	PhaseTimer timer(m_metrics, Phase::INTERACT);
 
-	// Reset Interactions
+	int nSharks = m_sharks.size();
 	for (int i = 0; i < m_nActors; i++)
-		m_actors[i]->setInteract(Interact::ALONE);
-
-	// Permute over Actors
-	// If actors are on top of eachother, have them interact
-	for (int i = 0; i < m_nActors - 1; i++) {
-		Point pos = m_actors[i]->getPosition();
-		for (int j = i + 1; j < m_nActors; j++) { // j never 0
-			if (pos == m_actors[j]->getPosition()) {
-				// Actor 0 is nemo, any interaction between nemo and anything
-				// else is an ATTACK
-				if (i == 0) {
-					m_actors[i]->setInteract(Interact::ATTACK);
-					m_actors[j]->setInteract(Interact::ATTACK);
-				}
-				else {
-					// If the sharks are attacking that means nemo is in the same cell
-					// as multiple sharks. Attacking takes precedence over greeting
-					if (m_actors[i]->getInteract() != Interact::ATTACK) {
-						m_actors[i]->setInteract(Interact::GREET);
-						m_actors[j]->setInteract(Interact::GREET);
-					}
-				}
+		m_occupancy[cellIndex(m_actors[i]->getPosition())]++;
+	for (int i = 0; i < nSharks; i++)
+		m_occupancy[m_sharks.y(i) * m_cols + m_sharks.x(i)]++;
+
+	int nemoCell = cellIndex(m_actors[0]->getPosition());
+	for (int i = 0; i < m_nActors; i++)
+		m_actors[i]->setInteract(interaction(cellIndex(m_actors[i]->getPosition()), nemoCell));
+	for (int i = 0; i < nSharks; i++)
+		m_sharks.setInteract(i, interaction(m_sharks.y(i) * m_cols + m_sharks.x(i), nemoCell));
+
+	// Empty the buckets again, touching only the occupied cells
+	for (int i = 0; i < m_nActors; i++)
+		m_occupancy[cellIndex(m_actors[i]->getPosition())] = 0;
+	for (int i = 0; i < nSharks; i++)
+		m_occupancy[m_sharks.y(i) * m_cols + m_sharks.x(i)] = 0;
+}
+
+// What happens to whoever is in cell, given where Nemo is
+Interact Aquarium::interaction(int cell, int nemoCell) const {
+	if (m_occupancy[cell] < 2)
+		return Interact::ALONE;
+	return cell == nemoCell ? Interact::ATTACK : Interact::GREET;
+}
+
+//  labelComponents()
+//		Give every open cell, and the start, the number of the region
+//		it belongs to.  Flood fills from each unlabelled cell in turn
+//		with an explicit stack, every cell is pushed at most once.
+void Aquarium::labelComponents() {
+	int cells = m_rows * m_cols;
+	int start = cellIndex(m_start);
+	m_component = new int[cells];
+	for (int cell = 0; cell < cells; cell++)
+		m_component[cell] = (m_openMask[cell] || cell == start) ? -2 : -1;	// -2 unlabelled
+
+	ArrayStack<int> stack;
+	for (int first = 0; first < cells; first++) {
+		if (m_component[first] != -2)
+			continue;
+
+		int label = m_componentSize.size();
+		int size = 0;
+		m_component[first] = label;
+		stack.push(first);
+		while (!stack.empty()) {
+			int cell = stack.top();
+			stack.pop();
+			size++;
+			int x = cell % m_cols;
+			int y = cell / m_cols;
+			// W, E, N, S
+			if (x > 0 && m_component[cell - 1] == -2) {
+				m_component[cell - 1] = label;
+				stack.push(cell - 1);
+			}
+			if (x < m_cols - 1 && m_component[cell + 1] == -2) {
+				m_component[cell + 1] = label;
+				stack.push(cell + 1);
+			}
+			if (y > 0 && m_component[cell - m_cols] == -2) {
+				m_component[cell - m_cols] = label;
+				stack.push(cell - m_cols);
+			}
+			if (y < m_rows - 1 && m_component[cell + m_cols] == -2) {
+				m_component[cell + m_cols] = label;
+				stack.push(cell + m_cols);
 			}
 		}
+		m_componentSize.push(size);
 	}
 }
-void Aquarium::draw() const {
 
+int Aquarium::componentOf(Point p) const {
+	unsigned x = (unsigned)p.getX();
+	unsigned y = (unsigned)p.getY();
+	if (x >= (unsigned)m_cols || y >= (unsigned)m_rows)
+		return -1;
+	return m_component[y * m_cols + x];
+}
+int Aquarium::componentSize(Point p) const {
+	int label = componentOf(p);
+	return label < 0 ? 0 : m_componentSize[label];
+}
+int Aquarium::numComponents() const {
+	return m_componentSize.size();
+}
+bool Aquarium::isReachable(Point a, Point b) const {
+	int label = componentOf(a);
+	return label >= 0 && label == componentOf(b);
+}
+bool Aquarium::solvable() const {
+	return isReachable(m_start, m_end);
+}
+
+int Aquarium::cellIndex(const Point& p) const {
+	return p.getY() * m_cols + p.getX();
+}
 
+// Place an actor drawn as sprite into the rendered cell c
+void Aquarium::stamp(char& c, char sprite) {
+	switch (c) {
+	case ' ': c = sprite; break; // Empty cell, just draw
+	case '@': c = '!'; break;	// ATTACK
+	case 'S': c = '2'; break;	// Two sharks
+	case '!':  break;			// MORE ATTACK. do nothing, already ded..
+	case '9':  break;			// do nothing
+	default: c++; break;		// '2' through '8', a party
+	}
+}
+
+void Aquarium::draw(std::string& frame) const {
+	PhaseTimer timer(m_metrics, Phase::DRAW);
 
 	// Copy the clean version of the aquarium into the rendered version
-	for (int y = 0; y < m_cols; y++) {
-		memcpy(m_renderedAquarium[y], m_aquarium[y], m_rows * sizeof(char));
-	}
+	memcpy(m_renderedAquarium.data(), m_aquarium.data(), m_aquarium.size() * sizeof(char));
 
 	// Encode the output, go through all actors and place them in the Aquarium
 	// Nemo: '@', Sharks: 'S', Multiple Shars: '2'-'9', An Attack '!'
-	for (int i = 0; i < m_nActors; i++) {
-		Point pos = m_actors[i]->getPosition();
-		// Reference to the the character at this position, for convenience
-		char& c = m_renderedAquarium[pos.getX()][pos.getY()];
-		switch (c) {
-		case ' ': c = m_actors[i]->draw(); break; // Empty cell, just draw
-		case '@': c = '!'; break;	// ATTACK
-		case 'S': c = '2'; break;	// Two sharks
-		case '!':  break;			// MORE ATTACK. do nothing, already ded..
-		case '9':  break;			// do nothing
-		default: c++; break;		// '2' through '8', a party
-		}
-	}
+	for (int i = 0; i < m_nActors; i++)
+		stamp(m_renderedAquarium.at(m_actors[i]->getPosition()), m_actors[i]->draw());
+	for (int i = 0; i < m_sharks.size(); i++)
+		stamp(m_renderedAquarium.at(m_sharks.x(i), m_sharks.y(i)), m_sharks.draw());
 	// Render the next point to visit for looking
 
 	if (!(m_player->stuck() || m_player->foundExit())) {
 		Point target = m_player->getTargetPoint();
 		if (target.getX() >= 0 && target.getY() >= 0)
-			m_renderedAquarium[target.getX()][target.getY()] = 'T';
+			m_renderedAquarium.at(target) = 'T';
 	}
 
 
-	// Draw aquarium with actors
+	// Draw aquarium with actors, a row at a time
+	frame.reserve(frame.size() + (size_t)m_rows * (m_cols + 1));
 	for (int y = 0; y < m_rows; y++) {
-		for (int x = 0; x < m_cols; x++) {
-			std::cout << m_renderedAquarium[x][y];
-		}
-		std::cout << std::endl;
+		frame.append(m_renderedAquarium.row(y), m_cols);
+		frame += '\n';
 	}
-	std::cout << "===" << std::endl;
+	frame += "===\n";
 
 	// Display actors Interactions
+	std::ostringstream says;
 	for (int i = 0; i < m_nActors; i++) {
-		m_actors[i]->say();
-		std::cout << std::endl;
+		m_actors[i]->say(says);
+		says << '\n';
 	}
+	for (int i = 0; i < m_sharks.size(); i++) {
+		m_sharks.say(i, says);
+		says << '\n';
+	}
+	frame += says.str();
+}
+
+void Aquarium::draw() const {
+	std::string frame;
+	draw(frame);
+	std::cout.write(frame.data(), frame.size());
+	std::cout.flush();
 }
 
 int	Aquarium::rows() const {
@@ -196,28 +444,113 @@ int	Aquarium::cols() const {
 	return m_cols;
 }
 int	Aquarium::numOpenCells() const {
-	return m_openCells.size();
+	return m_nOpen;
 }
 Player* Aquarium::player() const {
 	return m_player;
 }
+Point Aquarium::getStartPoint() const {
+	return m_start;
+}
 Point Aquarium::getEndPoint() const {
 	return m_end;
 }
+int Aquarium::solve(List<Point>* path) const {
+	ParallelBfs bfs(m_openMask, m_rows, m_cols);
+	return bfs.solve(m_start, m_end, m_pool, path);
+}
+int Aquarium::solve(PackedPath* path) const {
+	ParallelBfs bfs(m_openMask, m_rows, m_cols);
+	return bfs.solve(m_start, m_end, m_pool, path);
+}
+const List<Point>& Aquarium::openCells() const {
+	// Built on first use from the mask, most runs never need it
+	if (!m_openCellsBuilt) {
+		for (int y = 0; y < m_rows; y++) {
+			for (int x = 0; x < m_cols; x++) {
+				if (m_openMask[y * m_cols + x])
+					m_openCells.emplace_front(x, y);
+			}
+		}
+		m_openCellsBuilt = true;
+	}
+	return m_openCells;
+}
+const Bitboard& Aquarium::openBits() const {
+	return m_openBits;
+}
+const DistanceField& Aquarium::distanceField() const {
+	if (!m_field)
+		m_field = DistanceField::cached(m_openBits, m_start, m_end);
+	return *m_field;
+}
+int Aquarium::distanceToExit(Point p) const {
+	return distanceField().distance(p);
+}
+bool Aquarium::routeToExit(Point p, PackedPath& path) const {
+	return distanceField().route(p, path);
+}
+uint64_t Aquarium::contentHash() const {
+	return DistanceField::hash(m_openBits, m_start, m_end);
+}
 bool Aquarium::isCellOpen(Point p) const {
-	return (m_openCells.find(p) != -1);
+	// Casting to unsigned folds the < 0 and >= extent checks into one
+	unsigned x = (unsigned)p.getX();
+	unsigned y = (unsigned)p.getY();
+	if (x >= (unsigned)m_cols || y >= (unsigned)m_rows)
+		return false;
+	return m_openMask[y * m_cols + x];
 }
 int Aquarium::addSharks() {
+	return addSharks(1);
+}
 
-	// Randomly place sharks
+int Aquarium::addSharks(int count) {
+
+	// Sharks spawn where they can reach Nemo, anywhere in the player's
+	// region but the start
+	if (!m_spawnCellsBuilt) {
+		int home = m_component[cellIndex(m_start)];
+		for (int cell = 0; cell < m_rows * m_cols; cell++) {
+			if (m_component[cell] == home && m_openMask[cell])
+				m_spawnCells.push(cell);
+		}
+		m_spawnCellsBuilt = true;
+	}
 	Point p;
-	do {
-		int index = randInt(0, m_openCells.size() - 1);
-		p = m_openCells.get_at(index);
+	Point nemo = m_player->getPosition();
+	int nemoCell = cellIndex(nemo);
+	// Nemo standing on the only spawn cell leaves none to pick from
+	bool blocked = m_spawnCells.size() == 1 && m_spawnCells[0] == nemoCell;
+	if (m_spawnCells.size() > 0 && !blocked) {
+		// Every pick at once, only one landing on Nemo is drawn again
+		int last = m_spawnCells.size() - 1;
+		int* picks = new int[count];
+		m_rng.fill(picks, count, 0, last);
+		for (int i = 0; i < count; i++) {
+			int index = m_spawnCells[picks[i]];
+			while (index == nemoCell)
+				index = m_spawnCells[m_rng.nextInt(0, last)];
+			m_sharks.add(Point(index % m_cols, index / m_cols));
+		}
+		delete[] picks;
+		return m_nActors + m_sharks.size();
+	}
+
+	// Nemo is walled in alone, fall back to any open cell.
+	// Draw cells uniformly and keep the first
+	// open one, same distribution as picking from the open cell list
+	// but without walking it.  Nowhere at all, no shark.
+	if (m_nOpen - (isCellOpen(nemo) ? 1 : 0) <= 0)
+		return m_nActors + m_sharks.size();
+	for (int i = 0; i < count; i++) {
+		do {
+			int index = m_rng.nextInt(0, m_rows * m_cols - 1);
+			p.set(index % m_cols, index / m_cols);
 
-	} while ((p == m_player->getPosition())); // Don't start where the player starts
+		} while (!m_openMask[p.getY() * m_cols + p.getX()] || (p == nemo)); // Don't start where the player starts
 
-	std::string name = "Shark " + std::to_string((m_nActors - 1));
-	m_actors[m_nActors++] = new Shark(this, p, name, 'S');
-	return m_nActors;
+		m_sharks.add(p);
+	}
+	return m_nActors + m_sharks.size();
 }
\ No newline at end of file
@@ -3,44 +3,140 @@
 
 #include"list.h"
 #include"point.h"
+#include"grid.h"
+#include"search.h"
+#include"arraystack.h"
+#include"shark.h"
+#include"rng.h"
 #include"utils.h"
+#include"metrics.h"
+#include"bitboard.h"
+#include"distancefield.h"
+#include<memory>
 
-const int MAX_ACTORS = 50;
 class Player;
 class Actor;
+class ThreadPool;
 
 class Aquarium {
 public:
 
 	// Constructor: create the aquarium from file.
-	// file must not have any white space after last
-	// col and must have one newline after last row.
+	// Every row must be as wide as the first and hold only
+	// 'X', ' ', one 'S' and one 'E'.  Rows end in "\n" or
+	// "\r\n", the final newline is optional.
 	// Creates the player, sets the starting and end 
 	// points
 	Aquarium(std::string filename);
+	// Same from maze text in memory, e.g. from MazeGenerator::text()
+	Aquarium(const char* text, size_t size);
 	~Aquarium();
 
+	// Same as the constructors but nullptr with error set on a bad
+	// maze instead of exiting, for callers that must carry on
+	static Aquarium* create(const std::string& filename, std::string& error);
+	static Aquarium* create(const char* text, size_t size, std::string& error);
+
 	int		rows() const;	// Get the size of the aqarium
 	int		cols() const;
 
 	int		numOpenCells() const;
-	bool	isCellOpen(Point p) const;
+	bool	isCellOpen(Point p) const;	// O(1), looks up m_openMask
+
+	// The open cells again a bit each, for neighbour masks in a few
+	// shifts.  Same cells as isCellOpen(), the start is not open.
+	const Bitboard& openBits() const;
 
+	// All the open cells as a List, for callers that need to walk them
+	const List<Point>& openCells() const;
+
+	Point   getStartPoint() const;
 	Point   getEndPoint() const;
 
+	// Connected regions of the aquarium, labelled when it is loaded.
+	// The start counts as part of the region around it.  All O(1).
+	int		componentOf(Point p) const;		// -1 for rock or outside
+	int		componentSize(Point p) const;	// Cells in p's region, 0 for rock
+	int		numComponents() const;
+	bool	isReachable(Point a, Point b) const;
+	bool	solvable() const;				// Exit reachable from the start
+
+	// Shortest number of steps from start to exit, -1 if there is no
+	// way out, found by a parallel breadth first search on the
+	// setThreads() pool.  With a path, fills in one such route.
+	// Does not move any actors.
+	int		solve(List<Point>* path = nullptr) const;
+	int		solve(PackedPath* path) const;	// Same, the route as direction codes
+
+	// Steps from every cell to the exit, built by one breadth first
+	// search on first use.  Shared through DistanceField::cached() with
+	// every other aquarium holding the same maze.
+	const DistanceField& distanceField() const;
+	int		distanceToExit(Point p) const;	// -1 for rock or no way out
+	// Shortest route from p by walking the field downhill, O(steps)
+	bool	routeToExit(Point p, PackedPath& path) const;
+	// Hash of the maze, equal for equal mazes however they were loaded
+	uint64_t contentHash() const;
+
 	Player* player() const;	// Get the player from the Aquarium
+	// Add a shark anywhere Nemo is not, in Nemo's region if it can.
+	// Adds none if Nemo holds the only open cell.  Returns the actors.
 	int		addSharks();
+	// Same for count sharks, their spawn cells drawn in one Rng::fill().
+	// While Nemo is off the spawn cells, as at the start of a game, they
+	// land where count calls to addSharks() would put them.
+	int		addSharks(int count);
+
+	// Replay everything random from seed: shark placement and moves.
+	// Until called the aquarium is seeded from std::random_device.
+	void	seed(uint64_t seed);
+
+	// Threads moving the sharks each step, 0 for one per hardware
+	// thread.  Any count gives the same run.
+	void	setThreads(int threads);
 	void	setPlayerBackTracking(bool toggle);
+	void	setPlayerSearch(SearchKind kind);
 
-	double  getPlayerUpdateRunTime();
+	double  getPlayerUpdateRunTime();	// Total nanoseconds in Player::update
+
+	// Latency of every update(), interact() and draw() so far, by phase
+	Metrics&		metrics();
+	const Metrics&	metrics() const;
 
 	void	update();		// Update the aquarium by one step
 	void	interact();		// Update the Actors' interactions
 	void	draw() const;	// Draw the aquarium with actors
 
+	// Append the drawing to frame instead of writing it out
+	void	draw(std::string& frame) const;
+
 private:
 
-	List<Point> m_openCells;	// Store all the cells actors can move to
+	// Nothing loaded yet, the constructors and create() go on from here
+	Aquarium();
+
+	// Map filename and load() it, false and error set if it cannot be
+	bool	loadFile(const std::string& filename, std::string& error);
+	// Parse maze text into the grids, false and error set if malformed
+	bool	load(const char* text, size_t size, std::string& error);
+	void	allocateGrids(int maxRows);
+	// Labels, the player and the rest, once the maze is loaded
+	void	setup();
+
+	int		cellIndex(const Point& p) const;	// [y * m_cols + x]
+	// Flood fill every region, filling m_component and m_componentSize
+	void	labelComponents();
+	Interact interaction(int cell, int nemoCell) const;
+	static void stamp(char& c, char sprite);
+
+	// Store all the cells actors can move to, built on first use
+	mutable List<Point> m_openCells;
+	mutable bool m_openCellsBuilt;
+	int		m_nOpen;
+	bool*	m_openMask;			// Same cells indexed by [y * m_cols + x]
+	Bitboard m_openBits;		// And packed 64 to a word
+
+	mutable std::shared_ptr<const DistanceField> m_field;	// Built by distanceField()
 
 	int		m_rows;				// Extents of the Aquarium
 	int		m_cols;
@@ -48,16 +144,37 @@ private:
 	Point	m_start;			// Start of the maze
 	Point	m_end;				// End point of the maze
 
-	char** m_aquarium;			// Aqaurium template created from file
-	char** m_renderedAquarium;	// Copy of aquarium with actors drawn
+	// Both grids live in one cache line aligned block, m_gridBlock
+	// is the raw allocation they were carved out of
+	char*	m_gridBlock;
+	Grid	m_aquarium;			// Aqaurium template created from file
+	mutable Grid m_renderedAquarium;	// Copy of aquarium with actors drawn
 
 	Player* m_player;			// Dynamically allocated player
 
-	Actor* m_actors[MAX_ACTORS]; // Polymorphic array of actors
+	ArrayStack<Actor*> m_actors; // Polymorphic array of actors
 								  // The player is always the 0th element
 	int		m_nActors;
 
-	double  m_duration;		// How long Player::update takes to execute
+	SharkSchool m_sharks;		// Every shark, updated as one batch
+
+	Rng		m_rng;				// Shark placement, m_sharks moves on its own stream
+
+	ThreadPool* m_pool;			// nullptr when updating on one thread
+
+	int*	m_component;		// Region of every cell, -1 for rock
+	ArrayStack<int> m_componentSize;	// Cells per region
+
+	// Where sharks may spawn, the cells of the player's region other
+	// than the start.  Built by the first addSharks().
+	ArrayStack<int> m_spawnCells;
+	bool	m_spawnCellsBuilt;
+
+	// Number of actors and sharks in each cell, indexed like m_openMask.  All
+	// zero between calls to interact(), which fills and empties it.
+	int*	m_occupancy;
+
+	mutable Metrics m_metrics;	// How long each phase takes, draw() is const
 
 
 };
@@ -0,0 +1,261 @@
+#ifndef ARRAYSTACK_H
+#define ARRAYSTACK_H
+
+#include<iostream>
+#include<assert.h>
+#include<new>
+#include<utility>
+
+// Stack ADT using a contiguous array as primary data structure.
+//
+// Drop-in replacement for Stack: same push/pop/peek/empty/print.
+// Items sit next to each other in one block, no per item node or
+// heap allocation.  When the block fills up its capacity doubles
+// (never below MIN_CAPACITY), reserve() can size it up front.
+template<typename Type>
+class ArrayStack {
+public:
+
+	ArrayStack();
+	ArrayStack(const ArrayStack<Type>& other);
+	ArrayStack(ArrayStack<Type>&& other);
+	ArrayStack<Type>& operator=(ArrayStack<Type> other);
+	~ArrayStack();
+
+	// Basic stack operations
+	void	push(const Type& item);
+	void	push(Type&& item);
+	template<typename... Args>
+	void	emplace(Args&&... args);
+	void	pop();
+
+	// Note that the user must first ensure the stack is not empty
+	// prior to calling these functions.
+	const Type& peek() const;
+	Type&		top();
+	const Type& top() const;
+
+	// Item i from the bottom, for callers that keep their own order
+	// in the block (e.g. a heap)
+	Type&		operator[](int i);
+	const Type& operator[](int i) const;
+
+	// Check to see if there is anything on the stack
+	bool	empty() const;
+	int		size() const;
+
+	// Make room for at least n items without further growth
+	void	reserve(int n);
+	int		capacity() const;
+	void	clear();
+
+	// Number of times the block was (re)allocated
+	int		allocations() const;
+
+	// Use to see what is in the stack for debugging
+	void	print() const;
+
+	void	swap(ArrayStack<Type>& other);
+
+#ifndef MAKE_MEMBERS_PUBLIC
+private:
+#endif
+
+	static const int MIN_CAPACITY = 16;
+
+	// Grow the block before adding one more item
+	void	grow();
+
+	Type*	m_data;		// Raw storage, [0, m_size) are constructed
+	int		m_size;
+	int		m_capacity;
+	int		m_allocations;
+};
+
+// ArrayStack Implementation
+//
+
+// ArrayStack() Default constructor:
+//		Starts with no storage, the first push allocates.
+template<typename Type>
+ArrayStack<Type>::ArrayStack() :m_data(nullptr), m_size(0), m_capacity(0), m_allocations(0) {}
+
+// Copy constructor:
+//		Copies the items, only allocates as much as other holds.
+template<typename Type>
+ArrayStack<Type>::ArrayStack(const ArrayStack<Type>& other)
+	:m_data(nullptr), m_size(0), m_capacity(0), m_allocations(0) {
+	reserve(other.m_size);
+	for (int i = 0; i < other.m_size; i++)
+		push(other.m_data[i]);
+}
+
+// Move constructor:
+//		Takes over other's block, leaves other empty.
+template<typename Type>
+ArrayStack<Type>::ArrayStack(ArrayStack<Type>&& other)
+	:m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity),
+	m_allocations(other.m_allocations) {
+	other.m_data = nullptr;
+	other.m_size = other.m_capacity = 0;
+}
+
+// Assignment:
+//		other is already a copy (or moved in), swap with it.
+template<typename Type>
+ArrayStack<Type>& ArrayStack<Type>::operator=(ArrayStack<Type> other) {
+	swap(other);
+	return *this;
+}
+
+template<typename Type>
+ArrayStack<Type>::~ArrayStack() {
+	clear();
+	::operator delete(m_data);
+}
+
+template<typename Type>
+void ArrayStack<Type>::grow() {
+	reserve(m_capacity < MIN_CAPACITY ? MIN_CAPACITY : m_capacity * 2);
+}
+
+// reserve():
+//		Move the items into a block for at least n items.
+template<typename Type>
+void ArrayStack<Type>::reserve(int n) {
+	if (n <= m_capacity)
+		return;
+	Type* data = static_cast<Type*>(::operator new(n * sizeof(Type)));
+	m_allocations++;
+	for (int i = 0; i < m_size; i++) {
+		new (data + i) Type(std::move(m_data[i]));
+		m_data[i].~Type();
+	}
+	::operator delete(m_data);
+	m_data = data;
+	m_capacity = n;
+}
+
+// push():
+//		Add item on the top of the stack.
+template<typename Type>
+void ArrayStack<Type>::push(const Type& item) {
+	if (m_size == m_capacity) {
+		// item may live in the block that is about to move
+		Type copy(item);
+		grow();
+		new (m_data + m_size++) Type(std::move(copy));
+		return;
+	}
+	new (m_data + m_size++) Type(item);
+}
+
+template<typename Type>
+void ArrayStack<Type>::push(Type&& item) {
+	if (m_size == m_capacity)
+		grow();
+	new (m_data + m_size++) Type(std::move(item));
+}
+
+// emplace():
+//		Construct an item on the top of the stack in place.
+template<typename Type>
+template<typename... Args>
+void ArrayStack<Type>::emplace(Args&&... args) {
+	if (m_size == m_capacity)
+		grow();
+	new (m_data + m_size) Type(std::forward<Args>(args)...);
+	m_size++;
+}
+
+// pop():
+//		Remove the item on the "top" of the stack.
+template<typename Type>
+void ArrayStack<Type>::pop() {
+	if (m_size == 0)
+		return;
+	m_data[--m_size].~Type();
+}
+
+// peek()/top():
+//		Look at the "top" of the stack without changing the
+//		Stack itself.
+template<typename Type>
+const Type& ArrayStack<Type>::peek() const {
+	assert(m_size > 0);
+	return m_data[m_size - 1];
+}
+
+template<typename Type>
+Type& ArrayStack<Type>::top() {
+	assert(m_size > 0);
+	return m_data[m_size - 1];
+}
+
+template<typename Type>
+const Type& ArrayStack<Type>::top() const {
+	return peek();
+}
+
+template<typename Type>
+Type& ArrayStack<Type>::operator[](int i) {
+	assert(i >= 0 && i < m_size);
+	return m_data[i];
+}
+
+template<typename Type>
+const Type& ArrayStack<Type>::operator[](int i) const {
+	assert(i >= 0 && i < m_size);
+	return m_data[i];
+}
+
+template<typename Type>
+bool ArrayStack<Type>::empty() const {
+	return m_size == 0;
+}
+
+template<typename Type>
+int ArrayStack<Type>::size() const {
+	return m_size;
+}
+
+template<typename Type>
+int ArrayStack<Type>::capacity() const {
+	return m_capacity;
+}
+
+template<typename Type>
+int ArrayStack<Type>::allocations() const {
+	return m_allocations;
+}
+
+// clear():
+//		Remove every item, keeps the block for reuse.
+template<typename Type>
+void ArrayStack<Type>::clear() {
+	while (m_size > 0)
+		m_data[--m_size].~Type();
+}
+
+// print()
+//		Print to console the elements, bottom to top like Stack.
+//		Used for debugging.
+template<typename Type>
+void ArrayStack<Type>::print() const {
+	if (m_size == 0)
+		return;
+	std::cout << m_data[0];
+	for (int i = 1; i < m_size; i++)
+		std::cout << ' ' << m_data[i];
+	std::cout << std::endl;
+}
+
+template<typename Type>
+void ArrayStack<Type>::swap(ArrayStack<Type>& other) {
+	std::swap(m_data, other.m_data);
+	std::swap(m_size, other.m_size);
+	std::swap(m_capacity, other.m_capacity);
+	std::swap(m_allocations, other.m_allocations);
+}
+
+#endif//ARRAYSTACK_H
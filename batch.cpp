@@ -0,0 +1,256 @@
+#include"batch.h"
+#include"threadpool.h"
+#include<algorithm>
+#include<chrono>
+#include<fstream>
+#include<iostream>
+#include<mutex>
+#include<sstream>
+#include<thread>
+
+// One worker's share of the jobs, [begin, end).  The owner takes from
+// the front, thieves from the back, both under the lock.
+struct JobRange {
+	std::mutex	lock;
+	int			begin;
+	int			end;
+};
+
+// Next job for worker self, its own first then stolen, -1 when all
+// shares are empty.  Jobs are whole games, a lock per take is noise.
+static int takeJob(JobRange* ranges, int nRanges, int self) {
+	{
+		std::lock_guard<std::mutex> lock(ranges[self].lock);
+		if (ranges[self].begin < ranges[self].end)
+			return ranges[self].begin++;
+	}
+	for (int k = 1; k < nRanges; k++) {
+		JobRange& victim = ranges[(self + k) % nRanges];
+		std::lock_guard<std::mutex> lock(victim.lock);
+		if (victim.begin < victim.end)
+			return --victim.end;
+	}
+	return -1;
+}
+
+BatchRunner::BatchRunner(int threads) :m_jobs(), m_results(), m_threads(threads), m_seconds(0) {
+	if (m_threads <= 0)
+		m_threads = ThreadPool::hardwareThreads();
+}
+
+bool BatchRunner::load(const std::string& listFile, const Settings& base, std::string& error) {
+	std::ifstream file(listFile);
+	if (!file.is_open()) {
+		error = "could not open file " + listFile;
+		return false;
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line)) {
+		lineNumber++;
+		std::istringstream words(line);
+		std::string maze;
+		if (!(words >> maze) || maze[0] == '#')
+			continue;
+
+		BatchJob job;
+		job.settings = base;
+		job.line = lineNumber;
+		// A line of settings only, e.g. a generated maze
+		std::string word = maze.find('=') == std::string::npos ? "mazeFile=" + maze : maze;
+		bool ok = true;
+		do {
+			// Maze files are opened when the job runs, one that is
+			// missing fails that job alone
+			const std::string mazeFile = "mazeFile=";
+			if (word.compare(0, mazeFile.size(), mazeFile) == 0) {
+				job.settings.mazeFile = word.substr(mazeFile.size());
+				job.settings.generateMaze = false;
+			}
+			else
+				ok = job.settings.apply(word, error);
+		} while (ok && words >> word);
+		if (!ok) {
+			error = listFile + " line " + std::to_string(lineNumber) + ": " + error;
+			return false;
+		}
+		m_jobs.push(job);
+	}
+	return true;
+}
+
+void BatchRunner::add(const Settings& settings) {
+	BatchJob job;
+	job.settings = settings;
+	job.line = 0;
+	m_jobs.push(job);
+}
+
+// Row for a job whose game could not be set up
+static GameResult failedResult(const Settings& settings, const std::string& error) {
+	GameResult result = GameResult();
+	result.mazeFile = settings.mazeName();
+	result.search = settings.search;
+	result.seed = settings.seed;
+	result.numSharks = settings.numSharks;
+	result.outcome = "ERROR";
+	result.error = error;
+	return result;
+}
+
+//  run()
+//		Split the jobs evenly over the workers, the calling thread
+//		being worker 0, and let them take and steal until all are done.
+//		Games move their sharks inline, the batch already has every
+//		core busy.  A job that cannot be set up gets an ERROR row and
+//		the rest carry on.
+void BatchRunner::run() {
+	int n = m_jobs.size();
+	m_results.clear();
+	m_results.reserve(n);
+	for (int i = 0; i < n; i++)
+		m_results.push(GameResult());
+
+	int workers = std::min(m_threads, std::max(n, 1));
+	JobRange* ranges = new JobRange[workers];
+	for (int w = 0; w < workers; w++) {
+		ranges[w].begin = (int)((long long)n * w / workers);
+		ranges[w].end = (int)((long long)n * (w + 1) / workers);
+	}
+
+	auto work = [&](int self) {
+		for (int job = takeJob(ranges, workers, self); job >= 0; job = takeJob(ranges, workers, self)) {
+			Settings settings = m_jobs[job].settings;
+			settings.headless = true;
+			settings.numThreads = 1;
+			std::string error;
+			Game* game = Game::create(settings, error);
+			if (game == nullptr) {
+				m_results[job] = failedResult(settings, error);
+				continue;
+			}
+			m_results[job] = game->runHeadless();
+			delete game;
+		}
+	};
+
+	auto t1 = std::chrono::steady_clock::now();
+	std::thread* threads = new std::thread[workers - 1];
+	for (int w = 1; w < workers; w++)
+		threads[w - 1] = std::thread(work, w);
+	work(0);
+	for (int w = 1; w < workers; w++)
+		threads[w - 1].join();
+	auto t2 = std::chrono::steady_clock::now();
+	m_seconds = std::chrono::duration<double>(t2 - t1).count();
+
+	delete[] threads;
+	delete[] ranges;
+}
+
+int BatchRunner::size() const {
+	return m_jobs.size();
+}
+int BatchRunner::threads() const {
+	return m_threads;
+}
+double BatchRunner::seconds() const {
+	return m_seconds;
+}
+const GameResult& BatchRunner::result(int i) const {
+	return m_results[i];
+}
+
+bool BatchRunner::writeReport(const std::string& filename) const {
+	std::ofstream file(filename);
+	if (!file.is_open())
+		return false;
+	const std::string json = ".json";
+	if (filename.size() >= json.size() &&
+		filename.compare(filename.size() - json.size(), json.size(), json) == 0)
+		writeJson(file);
+	else
+		writeCsv(file);
+	return (bool)file;
+}
+
+// Maze file names go out quoted, with quotes and backslashes escaped
+static void writeQuoted(std::ostream& os, const std::string& text, char escape) {
+	os << '"';
+	for (char c : text) {
+		if (c == '"' || c == escape)
+			os << escape;
+		os << c;
+	}
+	os << '"';
+}
+
+void BatchRunner::writeCsv(std::ostream& os) const {
+	os << "maze,search,seed,sharks,outcome,steps,steps_taken,nodes_expanded,seconds,error\n";
+	for (int i = 0; i < m_results.size(); i++) {
+		const GameResult& r = m_results[i];
+		writeQuoted(os, r.mazeFile, '"');
+		os << ',' << searchKindName(r.search) << ',' << r.seed << ',' << r.numSharks
+			<< ',' << r.outcome << ',' << r.steps << ',' << r.stepsTaken
+			<< ',' << r.nodesExpanded << ',' << r.seconds << ',';
+		writeQuoted(os, r.error, '"');
+		os << '\n';
+	}
+}
+
+void BatchRunner::writeJson(std::ostream& os) const {
+	os << "{\n  \"threads\": " << m_threads << ",\n  \"seconds\": " << m_seconds
+		<< ",\n  \"games\": [";
+	for (int i = 0; i < m_results.size(); i++) {
+		const GameResult& r = m_results[i];
+		os << (i == 0 ? "\n" : ",\n") << "    {\"maze\": ";
+		writeQuoted(os, r.mazeFile, '\\');
+		os << ", \"search\": \"" << searchKindName(r.search) << "\", \"seed\": \"" << r.seed
+			<< "\", \"sharks\": " << r.numSharks << ", \"outcome\": \"" << r.outcome
+			<< "\", \"steps\": " << r.steps << ", \"steps_taken\": " << r.stepsTaken
+			<< ", \"nodes_expanded\": " << r.nodesExpanded << ", \"seconds\": " << r.seconds << ", \"error\": ";
+		writeQuoted(os, r.error, '\\');
+		os << "}";
+	}
+	os << "\n  ]\n}\n";
+}
+
+int runBatch(const std::string& listFile, const std::string& reportFile,
+	const std::string& settingsFile, int threads) {
+
+	// The settings file is optional here, it only supplies defaults
+	Settings base;
+	std::string error;
+	std::ifstream probe(settingsFile);
+	if (probe.is_open()) {
+		probe.close();
+		if (!base.load(settingsFile, error)) {
+			std::cerr << "ERROR Batch: " << error << "\n\tExiting." << std::endl;
+			return 1;
+		}
+	}
+
+	BatchRunner runner(threads);
+	if (!runner.load(listFile, base, error)) {
+		std::cerr << "ERROR Batch: " << error << "\n\tExiting." << std::endl;
+		return 1;
+	}
+
+	runner.run();
+
+	if (!runner.writeReport(reportFile)) {
+		std::cerr << "ERROR Batch: could not write report " << reportFile << ". Exiting." << std::endl;
+		return 1;
+	}
+	int failed = 0;
+	for (int i = 0; i < runner.size(); i++)
+		if (runner.result(i).error.size() > 0)
+			failed++;
+	if (failed > 0)
+		std::cerr << "WARNING Batch: " << failed << " of " << runner.size()
+			<< " games could not be set up, see the error column of " << reportFile << std::endl;
+	std::cout << "Ran " << runner.size() << " games on " << runner.threads() << " threads in "
+		<< runner.seconds() << " s, report in " << reportFile << std::endl;
+	return 0;
+}
@@ -0,0 +1,64 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include<string>
+#include"settings.h"
+#include"game.h"
+#include"arraystack.h"
+
+// One game of a batch: base settings plus the maze line's overrides
+struct BatchJob {
+	Settings	settings;
+	int			line;		// In the batch list, for messages
+};
+
+// Runs many headless games at once on a work-stealing pool.
+//
+// Every worker starts with an even share of the jobs and works through
+// it front to back.  A worker that runs dry steals from the back of the
+// others' shares, so a few slow mazes do not leave the other threads
+// idle.  Games are independent, each owns its aquarium and generator.
+class BatchRunner {
+public:
+	// threads 0 means one per hardware thread
+	explicit BatchRunner(int threads);
+
+	// Parse a batch list on top of base.  Every line is a maze file
+	// followed by optional setting=value overrides, or only overrides
+	// (generateMaze=prim mazeRows=999 ...).  Blank lines and lines
+	// starting with '#' are skipped.  False with error set on a bad
+	// setting.  Mazes are not opened here, a job whose maze is missing
+	// or malformed gets an ERROR result from run().
+	bool	load(const std::string& listFile, const Settings& base, std::string& error);
+	void	add(const Settings& settings);
+
+	// Run every job, results come back in job order.  Jobs that
+	// cannot be set up come back as ERROR, the others still run.
+	void	run();
+
+	int		size() const;
+	int		threads() const;
+	double	seconds() const;	// Wall time of the last run()
+	const GameResult& result(int i) const;
+
+	// Report of the results, JSON if filename ends in ".json" else CSV.
+	// JSON writes the seed as a string: seeds go past 2^53 and a JSON
+	// number that big comes back rounded as a double, so the game would
+	// not replay.  CSV leaves it a plain number.
+	bool	writeReport(const std::string& filename) const;
+	void	writeCsv(std::ostream& os) const;
+	void	writeJson(std::ostream& os) const;
+
+private:
+	ArrayStack<BatchJob>	m_jobs;
+	ArrayStack<GameResult>	m_results;
+	int		m_threads;
+	double	m_seconds;
+};
+
+// main's --batch mode, returns the process exit code.  settingsFile,
+// if it exists, gives the defaults every maze line starts from.
+int		runBatch(const std::string& listFile, const std::string& reportFile,
+	const std::string& settingsFile, int threads);
+
+#endif//BATCH_H
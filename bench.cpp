@@ -0,0 +1,454 @@
+// Benchmark suite, built as its own executable by Benchmarks.vcxproj.
+//
+//		Benchmarks [--quick] [--max-cells N] [--out results.json|results.csv]
+//
+// Every benchmark is run as a number of samples, each sample timing a
+// batch of operations.  Samples are summarised by their median and
+// median absolute deviation (MAD), which a stray context switch or page
+// fault does not drag around the way it does a mean.  Samples further
+// than 3 scaled MADs from the median are counted as outliers.
+//
+// The maze benchmarks run over MazeGenerator caves from 10^2 cells up
+// to --max-cells (10^7 by default, 10^8 needs a few GB of memory).  All
+// randomness is seeded, two runs measure the same work.
+#include"list.h"
+#include"stack.h"
+#include"queue.h"
+#include"arraystack.h"
+#include"ringqueue.h"
+#include"aquarium.h"
+#include"player.h"
+#include"rng.h"
+#include"mazegen.h"
+#include"distancefield.h"
+#include"settings.h"
+#include<algorithm>
+#include<chrono>
+#include<cmath>
+#include<cstdio>
+#include<cstring>
+#include<fstream>
+#include<iostream>
+#include<string>
+
+// One benchmark's summary
+struct Measurement {
+	std::string name;
+	long long	size;		// Elements, cells or actors, what the benchmark scales with
+	std::string unit;		// "ns/op", "ns/step", "ns/frame", "MB/s", "Mcells/s"
+	double		median;
+	double		mad;		// Median absolute deviation
+	double		min;
+	double		max;
+	int			samples;
+	int			outliers;
+};
+
+// All the measurements taken, in order
+static ArrayStack<Measurement> g_results;
+
+typedef std::chrono::steady_clock Clock;
+
+static double nanosSince(Clock::time_point t1) {
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t1).count();
+}
+
+static double median(double* values, int n) {
+	std::sort(values, values + n);
+	return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+// Keeps the optimiser from dropping work whose result is unused
+static volatile long long g_sink;
+
+//  measure()
+//		Call sample() once to warm up then samples times, each call
+//		returns the value of one sample in unit.  Records and prints
+//		the summary.
+template<typename Sample>
+static void measure(const std::string& name, long long size, const std::string& unit,
+	int samples, Sample sample) {
+
+	sample();
+	double* values = new double[samples];
+	for (int i = 0; i < samples; i++)
+		values[i] = sample();
+
+	Measurement m;
+	m.name = name;
+	m.size = size;
+	m.unit = unit;
+	m.samples = samples;
+	m.median = median(values, samples);
+	m.min = values[0];
+	m.max = values[samples - 1];
+
+	double* deviations = new double[samples];
+	for (int i = 0; i < samples; i++)
+		deviations[i] = std::fabs(values[i] - m.median);
+	m.mad = median(deviations, samples);
+
+	// 1.4826 scales the MAD to a standard deviation for normal noise
+	double limit = 3 * 1.4826 * m.mad;
+	m.outliers = 0;
+	for (int i = 0; i < samples; i++)
+		if (std::fabs(values[i] - m.median) > limit)
+			m.outliers++;
+
+	delete[] deviations;
+	delete[] values;
+
+	g_results.push(m);
+	printf("%-28s %12lld %12.2f %-8s +- %-10.2f (%d/%d outliers)\n", name.c_str(), size,
+		m.median, unit.c_str(), m.mad, m.outliers, samples);
+	fflush(stdout);
+}
+
+///////////////////////////////////////////////////////////////////////////
+//  Containers
+///////////////////////////////////////////////////////////////////////////
+
+static void benchContainers(int samples) {
+	const int n = 100000;
+
+	measure("List push_back/pop_front", n, "ns/op", samples, [&] {
+		List<int> list;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < n; i++)
+			list.push_back(i);
+		while (!list.empty())
+			list.pop_front();
+		return nanosSince(t1) / (2.0 * n);
+	});
+
+	const int small = 1000;
+	List<int> list;
+	for (int i = 0; i < small; i++)
+		list.push_back(i);
+
+	measure("List find", small, "ns/op", samples, [&] {
+		long long found = 0;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < 1000; i++)
+			found += list.find((i * 7919) % small);
+		double ns = nanosSince(t1) / 1000;
+		g_sink = found;
+		return ns;
+	});
+
+	measure("List get_at", small, "ns/op", samples, [&] {
+		long long sum = 0;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < 1000; i++)
+			sum += list.get_at((i * 7919) % small);
+		double ns = nanosSince(t1) / 1000;
+		g_sink = sum;
+		return ns;
+	});
+
+	measure("Stack push/pop", n, "ns/op", samples, [&] {
+		Stack<int> stack;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < n; i++)
+			stack.push(i);
+		while (!stack.empty())
+			stack.pop();
+		return nanosSince(t1) / (2.0 * n);
+	});
+
+	measure("Queue push/pop", n, "ns/op", samples, [&] {
+		Queue<int> queue;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < n; i++)
+			queue.push(i);
+		while (!queue.empty())
+			queue.pop();
+		return nanosSince(t1) / (2.0 * n);
+	});
+
+	measure("ArrayStack push/pop", n, "ns/op", samples, [&] {
+		ArrayStack<int> stack;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < n; i++)
+			stack.push(i);
+		while (!stack.empty())
+			stack.pop();
+		return nanosSince(t1) / (2.0 * n);
+	});
+
+	measure("RingQueue push/pop", n, "ns/op", samples, [&] {
+		RingQueue<int> queue;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < n; i++)
+			queue.push(i);
+		while (!queue.empty())
+			queue.pop();
+		return nanosSince(t1) / (2.0 * n);
+	});
+}
+
+///////////////////////////////////////////////////////////////////////////
+//  Mazes
+///////////////////////////////////////////////////////////////////////////
+
+// A side x side cave: walls round the edge, one cell in five a rock,
+// start and exit in opposite corners
+static MazeSpec cave(int side) {
+	return MazeSpec(MazeKind::OPEN, side, side, 42, 0.2);
+}
+
+static void benchMaze(int side, int samples) {
+	long long cells = (long long)side * side;
+	std::string filename = "bench_maze_" + std::to_string(side) + ".txt";
+	MazeGenerator::write(cave(side), filename);
+	long long bytes = (long long)side * (side + 1);
+
+	// Generating and loading are slow enough at the big sizes that
+	// fewer samples do
+	int bigSamples = cells >= 10000000 ? std::min(samples, 3) : samples;
+	const MazeKind kinds[] = { MazeKind::BACKTRACKER, MazeKind::PRIM, MazeKind::WILSON, MazeKind::OPEN };
+	char* grid = new char[cells];
+	for (MazeKind kind : kinds) {
+		MazeSpec spec(kind, side, side, 42, 0.2);
+		measure(std::string("generate ") + mazeKindName(kind), cells, "Mcells/s", bigSamples, [&] {
+			Clock::time_point t1 = Clock::now();
+			MazeGenerator::generate(spec, grid);
+			return cells / (nanosSince(t1) / 1e9) / 1e6;
+		});
+	}
+	delete[] grid;
+
+	measure("maze load", cells, "MB/s", bigSamples, [&] {
+		Clock::time_point t1 = Clock::now();
+		Aquarium aquarium(filename);
+		double ns = nanosSince(t1);
+		g_sink = aquarium.numOpenCells();
+		return bytes / (ns / 1e9) / 1e6;
+	});
+
+	Aquarium aquarium(filename);
+	aquarium.seed(7);
+
+	const int lookups = 100000;
+	Point* points = new Point[lookups];
+	Rng rng(3);
+	{
+		// x, y pairs, the same cells as drawing them one at a time
+		int* coords = new int[2 * lookups];
+		rng.fill(coords, 2 * lookups, 0, side - 1);
+		for (int i = 0; i < lookups; i++)
+			points[i].set(coords[2 * i], coords[2 * i + 1]);
+		delete[] coords;
+	}
+	measure("isCellOpen", cells, "ns/op", samples, [&] {
+		long long open = 0;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < lookups; i++)
+			open += aquarium.isCellOpen(points[i]);
+		double ns = nanosSince(t1) / lookups;
+		g_sink = open;
+		return ns;
+	});
+
+	// The four neighbours of the same random cells, one call at a
+	// time and as one bitboard mask
+	measure("neighbours isCellOpen", cells, "ns/op", samples, [&] {
+		long long open = 0;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < lookups; i++) {
+			int x = points[i].getX(), y = points[i].getY();
+			open += aquarium.isCellOpen(Point(x - 1, y)) + aquarium.isCellOpen(Point(x + 1, y))
+				+ aquarium.isCellOpen(Point(x, y - 1)) + aquarium.isCellOpen(Point(x, y + 1));
+		}
+		double ns = nanosSince(t1) / lookups;
+		g_sink = open;
+		return ns;
+	});
+	const Bitboard& bits = aquarium.openBits();
+	measure("neighbours bitboard", cells, "ns/op", samples, [&] {
+		long long open = 0;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < lookups; i++)
+			open += bits.neighborMask(points[i].getX(), points[i].getY());
+		double ns = nanosSince(t1) / lookups;
+		g_sink = open;
+		return ns;
+	});
+	delete[] points;
+
+	// Every dead end of the maze, open cells with one open neighbour,
+	// a word of 64 cells at a time
+	measure("dead ends by word", cells, "Mcells/s", samples, [&] {
+		long long ends = 0;
+		Clock::time_point t1 = Clock::now();
+		for (int y = 0; y < bits.rows(); y++) {
+			for (int w = 0; w < bits.words(); w++) {
+				NeighborWords n = bits.neighborWords(y, w);
+				// Exactly one of the four set: odd parity, not three
+				uint64_t odd = n.west ^ n.east ^ n.north ^ n.south;
+				uint64_t three = (n.west & n.east & (n.north | n.south)) | (n.north & n.south & (n.west | n.east));
+				ends += popCount64(n.open & odd & ~three);
+			}
+		}
+		double ns = nanosSince(t1);
+		g_sink = ends;
+		return cells / (ns / 1e9) / 1e6;
+	});
+
+	// One breadth first search over the whole maze, uncached
+	measure("distance field", cells, "Mcells/s", bigSamples, [&] {
+		Clock::time_point t1 = Clock::now();
+		DistanceField field(aquarium.openBits(), aquarium.getStartPoint(), aquarium.getEndPoint());
+		double ns = nanosSince(t1);
+		g_sink = field.reachable();
+		return cells / (ns / 1e9) / 1e6;
+	});
+
+	// Routes from random open cells once the field is there
+	const DistanceField& field = aquarium.distanceField();
+	const int routes = 100;
+	Point* starts = new Point[routes];
+	for (int i = 0; i < routes; i++) {
+		do
+			starts[i].set(rng.nextInt(0, side - 1), rng.nextInt(0, side - 1));
+		while (field.distance(starts[i]) < 0);
+	}
+	PackedPath route;
+	measure("route by field", cells, "ns/step", samples, [&] {
+		long long steps = 0;
+		Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < routes; i++) {
+			field.route(starts[i], route);
+			steps += route.size();
+		}
+		return steps > 0 ? nanosSince(t1) / steps : 0.0;
+	});
+	delete[] starts;
+
+	// Up to stepLimit moves of the player from the start each sample
+	const int stepLimit = 100000;
+	Player* player = aquarium.player();
+	measure("Player::update", cells, "ns/step", samples, [&] {
+		player->restart(aquarium.getStartPoint());
+		int steps = 0;
+		Clock::time_point t1 = Clock::now();
+		while (steps < stepLimit && !player->stuck() && !player->foundExit()) {
+			player->update();
+			steps++;
+		}
+		return steps > 0 ? nanosSince(t1) / steps : 0.0;
+	});
+
+	// A frame is as big as the maze, stop where nobody would draw it
+	if (cells <= 1000000) {
+		std::string frame;
+		measure("draw", cells, "ns/frame", samples, [&] {
+			const int frames = cells <= 10000 ? 100 : 5;
+			Clock::time_point t1 = Clock::now();
+			for (int i = 0; i < frames; i++) {
+				frame.clear();
+				aquarium.draw(frame);
+			}
+			return nanosSince(t1) / frames;
+		});
+	}
+
+	remove(filename.c_str());
+}
+
+// interact() on one maze as the number of sharks grows
+static void benchInteract(int samples) {
+	const int side = 1000;
+	std::string maze = MazeGenerator::text(cave(side));
+	Aquarium aquarium(maze.data(), maze.size());
+	aquarium.seed(11);
+
+	int sharks = 0;
+	for (int target = 10; target <= 100000; target *= 10) {
+		aquarium.addSharks(target - sharks);
+		sharks = target;
+		const int calls = target >= 100000 ? 10 : 100;
+		measure("interact", target + 1, "ns/call", samples, [&] {
+			Clock::time_point t1 = Clock::now();
+			for (int i = 0; i < calls; i++)
+				aquarium.interact();
+			return nanosSince(t1) / calls;
+		});
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
+//  Results
+///////////////////////////////////////////////////////////////////////////
+
+static bool endsWith(const std::string& text, const std::string& suffix) {
+	return text.size() >= suffix.size() &&
+		text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static bool writeResults(const std::string& filename) {
+	std::ofstream out(filename);
+	if (!out.is_open())
+		return false;
+
+	if (endsWith(filename, ".csv")) {
+		out << "name,size,unit,median,mad,min,max,samples,outliers\n";
+		for (int i = 0; i < g_results.size(); i++) {
+			const Measurement& m = g_results[i];
+			out << m.name << ',' << m.size << ',' << m.unit << ',' << m.median << ',' << m.mad
+				<< ',' << m.min << ',' << m.max << ',' << m.samples << ',' << m.outliers << '\n';
+		}
+		return (bool)out;
+	}
+
+	out << "{\n  \"benchmarks\": [";
+	for (int i = 0; i < g_results.size(); i++) {
+		const Measurement& m = g_results[i];
+		out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << m.name << "\", \"size\": " << m.size
+			<< ", \"unit\": \"" << m.unit << "\", \"median\": " << m.median << ", \"mad\": " << m.mad
+			<< ", \"min\": " << m.min << ", \"max\": " << m.max << ", \"samples\": " << m.samples
+			<< ", \"outliers\": " << m.outliers << "}";
+	}
+	out << "\n  ]\n}\n";
+	return (bool)out;
+}
+
+int main(int argc, char** argv) {
+	int samples = 15;
+	long long maxCells = 10000000;
+	std::string outFile = "bench_results.json";
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--quick")
+			samples = 5;
+		else if (arg == "--max-cells" && i + 1 < argc && parseNumber(argv[i + 1], maxCells) && maxCells > 0)
+			i++;
+		else if (arg == "--out" && i + 1 < argc)
+			outFile = argv[++i];
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--quick] [--max-cells N] [--out results.json|results.csv]" << std::endl;
+			return 1;
+		}
+	}
+
+	printf("%-28s %12s %12s\n", "benchmark", "size", "median");
+	benchContainers(samples);
+
+	// Sides for 10^2, 10^3, ... 10^8 cells
+	const int sides[] = { 10, 32, 100, 316, 1000, 3162, 10000 };
+	for (int side : sides) {
+		if ((long long)side * side > maxCells)
+			break;
+		benchMaze(side, samples);
+	}
+
+	benchInteract(samples);
+
+	if (!writeResults(outFile)) {
+		std::cerr << "ERROR Benchmarks: could not write " << outFile << ". Exiting." << std::endl;
+		return 1;
+	}
+	std::cout << "Results in " << outFile << std::endl;
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include"bitboard.h"
+#include<cstring>
+
+Bitboard::Bitboard() :m_bits(nullptr), m_rows(0), m_cols(0), m_stride(0) {
+}
+
+Bitboard::Bitboard(const bool* open, int rows, int cols)
+	:m_bits(nullptr), m_rows(0), m_cols(0), m_stride(0) {
+	assign(open, rows, cols);
+}
+
+Bitboard::~Bitboard() {
+	delete[] m_bits;
+}
+
+//  assign( ... )
+//		A pad word either side of the cells' words.  Packs a word at a
+//		time so the stores are not read-modify-writes.
+void Bitboard::assign(const bool* open, int rows, int cols) {
+	delete[] m_bits;
+	m_rows = rows;
+	m_cols = cols;
+	m_stride = (cols + 63) / 64 + 2;
+	size_t words = (size_t)(rows + 2) * m_stride;
+	m_bits = new uint64_t[words];
+	memset(m_bits, 0, words * sizeof(uint64_t));
+
+	for (int y = 0; y < rows; y++) {
+		uint64_t* r = m_bits + (size_t)(y + 1) * m_stride;
+		const bool* cells = open + (size_t)y * cols;
+		for (int x = 0; x < cols; x += 64) {
+			int n = cols - x < 64 ? cols - x : 64;
+			uint64_t word = 0;
+			for (int i = 0; i < n; i++)
+				word |= (uint64_t)cells[x + i] << i;
+			r[x / 64 + 1] = word;
+		}
+	}
+}
+
+//  neighborWords( ... )
+//		A cell has an open west neighbour when the bit below it is set,
+//		so the row is shifted up one with the top bit of the word to
+//		the left carried in, east the other way round.  North and south
+//		are the same word of the rows around.
+NeighborWords Bitboard::neighborWords(int y, int w) const {
+	const uint64_t* r = row(y) + w + 1;
+	NeighborWords n;
+	n.open = r[0];
+	n.west = (r[0] << 1) | (r[-1] >> 63);
+	n.east = (r[0] >> 1) | (r[1] << 63);
+	n.north = r[-m_stride];
+	n.south = r[m_stride];
+	return n;
+}
+
+int Bitboard::rows() const {
+	return m_rows;
+}
+int Bitboard::cols() const {
+	return m_cols;
+}
+int Bitboard::words() const {
+	return (m_cols + 63) / 64;
+}
+size_t Bitboard::bytes() const {
+	return (size_t)(m_rows + 2) * m_stride * sizeof(uint64_t);
+}
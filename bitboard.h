@@ -0,0 +1,111 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include<cstdint>
+#include<cstddef>
+
+// Neighbour bits of Bitboard::neighborMask(), in the W, E, N, S order
+// the searches discover cells in
+const unsigned NEIGHBOR_W = 1;
+const unsigned NEIGHBOR_E = 2;
+const unsigned NEIGHBOR_N = 4;
+const unsigned NEIGHBOR_S = 8;
+
+// The cells of word w in a row and which of them have an open
+// neighbour each way.  Bit i is cell 64 * w + i.
+struct NeighborWords {
+	uint64_t	open;
+	uint64_t	west;
+	uint64_t	east;
+	uint64_t	north;
+	uint64_t	south;
+};
+
+// Open cell mask of a rows x cols grid packed one bit per cell, 64
+// cells to a word.
+//
+// Every row is padded with a zero word on either side, and a zero row
+// sits above and below the grid, so the neighbours of any cell, edge
+// or not, are plain shifts and ANDs with no bounds checks.  Cell x of
+// a row is bit x + 64 of it.
+class Bitboard {
+public:
+	Bitboard();
+	// Built from a byte per cell mask, true for open
+	Bitboard(const bool* open, int rows, int cols);
+	~Bitboard();
+
+	// Rebuild from a byte per cell mask, forgets the old grid
+	void		assign(const bool* open, int rows, int cols);
+
+	// Outside the grid counts as closed
+	bool		test(int x, int y) const;
+
+	// NEIGHBOR_W | NEIGHBOR_E | NEIGHBOR_N | NEIGHBOR_S for the open
+	// neighbours of (x, y).  Note that (x, y) must be inside the grid.
+	unsigned	neighborMask(int x, int y) const;
+
+	// Cells 64 * w up to 64 * w + 63 of row y and their neighbours,
+	// bits past the last column are zero.  w < words().
+	NeighborWords neighborWords(int y, int w) const;
+
+	int			rows() const;
+	int			cols() const;
+	int			words() const;	// Words of cells per row
+	size_t		bytes() const;	// Storage, padding included
+
+private:
+	// Not copyable, the words are owned
+	Bitboard(const Bitboard& other);
+	Bitboard& operator=(const Bitboard& other);
+
+	// First word of row y, y may be -1 or rows() for the padding
+	const uint64_t* row(int y) const;
+
+	uint64_t*	m_bits;
+	int			m_rows;
+	int			m_cols;
+	int			m_stride;	// Words per row, padding included
+};
+
+// Number of set bits in word.  MSVC's __popcnt is the POPCNT
+// instruction with no fallback and faults on CPUs without it, so there
+// the bits are added up in parallel with shifts and masks instead.
+inline int popCount64(uint64_t word) {
+#ifdef _MSC_VER
+	word = word - ((word >> 1) & 0x5555555555555555ull);
+	word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+	return (int)((word * 0x0101010101010101ull) >> 56);
+#else
+	return __builtin_popcountll(word);
+#endif
+}
+
+// Bit b of a row starting at words
+inline uint64_t bitAt(const uint64_t* words, size_t b) {
+	return (words[b >> 6] >> (b & 63)) & 1;
+}
+
+inline const uint64_t* Bitboard::row(int y) const {
+	return m_bits + (size_t)(y + 1) * m_stride;
+}
+
+inline bool Bitboard::test(int x, int y) const {
+	// Casting to unsigned folds the < 0 and >= extent checks into one
+	if ((unsigned)x >= (unsigned)m_cols || (unsigned)y >= (unsigned)m_rows)
+		return false;
+	return bitAt(row(y), (size_t)x + 64) != 0;
+}
+
+// Four loads, no branches: the padding makes every neighbour exist
+inline unsigned Bitboard::neighborMask(int x, int y) const {
+	const uint64_t* r = row(y);
+	size_t b = (size_t)x + 64;
+	return (unsigned)(bitAt(r, b - 1)
+		| bitAt(r, b + 1) << 1
+		| bitAt(r - m_stride, b) << 2
+		| bitAt(r + m_stride, b) << 3);
+}
+
+#endif//BITBOARD_H
@@ -0,0 +1,249 @@
+#include"distancefield.h"
+#include"rng.h"
+#include"arraystack.h"
+#include<mutex>
+
+static const int DX[4] = { -1, 1, 0, 0 };
+static const int DY[4] = { 0, 0, -1, 1 };
+
+//  DistanceField( ... )
+//		Breadth first out of the exit over the open cells.  Every cell
+//		is queued once so the queue is a plain array, and a cell's open
+//		neighbours come from the bitboard in one mask.  The start is not
+//		open so it is given its distance last, one more than its
+//		closest neighbour.
+DistanceField::DistanceField(const Bitboard& open, Point start, Point exit)
+	:m_distance(nullptr), m_rows(open.rows()), m_cols(open.cols()), m_exit(exit), m_start(start),
+	m_reachable(0), m_maxDistance(0) {
+
+	int cells = m_rows * m_cols;
+	m_distance = new int[cells];
+	for (int i = 0; i < cells; i++)
+		m_distance[i] = -1;
+	if (!open.test(exit.getX(), exit.getY()))
+		return;
+
+	int* queue = new int[cells];
+	int head = 0, tail = 0;
+	m_distance[index(exit)] = 0;
+	queue[tail++] = index(exit);
+	while (head < tail) {
+		int cell = queue[head++];
+		int next = m_distance[cell] + 1;
+		unsigned mask = open.neighborMask(cell % m_cols, cell / m_cols);
+		for (int d = 0; d < 4; d++) {
+			if ((mask >> d & 1) == 0)
+				continue;
+			int n = cell + DY[d] * m_cols + DX[d];
+			if (m_distance[n] < 0) {
+				m_distance[n] = next;
+				queue[tail++] = n;
+			}
+		}
+	}
+	// Queued in order of distance, the last is the farthest
+	m_reachable = tail;
+	m_maxDistance = m_distance[queue[tail - 1]];
+	delete[] queue;
+
+	if (inside(start) && m_distance[index(start)] < 0) {
+		int best = -1;
+		for (int d = 0; d < 4; d++) {
+			int n = distance(PackedPath::step(start, d));
+			if (n >= 0 && (best < 0 || n < best))
+				best = n;
+		}
+		if (best >= 0) {
+			m_distance[index(start)] = best + 1;
+			m_reachable++;
+			if (best + 1 > m_maxDistance)
+				m_maxDistance = best + 1;
+		}
+	}
+}
+
+DistanceField::~DistanceField() {
+	delete[] m_distance;
+}
+
+int DistanceField::index(Point p) const {
+	return p.getY() * m_cols + p.getX();
+}
+
+bool DistanceField::inside(Point p) const {
+	// Casting to unsigned folds the < 0 and >= extent checks into one
+	return (unsigned)p.getX() < (unsigned)m_cols && (unsigned)p.getY() < (unsigned)m_rows;
+}
+
+int DistanceField::distance(Point p) const {
+	return inside(p) ? m_distance[index(p)] : -1;
+}
+
+//  downhill( ... )
+//		Any neighbour one closer is on a shortest route.  The start is
+//		never stepped onto, it has a distance but is not open.
+int DistanceField::downhill(Point p) const {
+	int here = distance(p);
+	if (here <= 0)
+		return -1;
+	for (int d = 0; d < 4; d++) {
+		Point n = PackedPath::step(p, d);
+		if (n != m_start && distance(n) == here - 1)
+			return d;
+	}
+	return -1;
+}
+
+//  route( ... )
+//		The route is distance(p) steps long, so size it once and walk
+//		downhill filling it in.
+bool DistanceField::route(Point p, PackedPath& path) const {
+	path.clear(p);
+	int steps = distance(p);
+	if (steps < 0)
+		return false;
+	path.resize(steps);
+	for (int i = 0; i < steps; i++) {
+		int d = downhill(p);
+		path.set(i, d);
+		p = PackedPath::step(p, d);
+	}
+	return true;
+}
+
+Point DistanceField::exit() const {
+	return m_exit;
+}
+int DistanceField::rows() const {
+	return m_rows;
+}
+int DistanceField::cols() const {
+	return m_cols;
+}
+int DistanceField::reachable() const {
+	return m_reachable;
+}
+int DistanceField::maxDistance() const {
+	return m_maxDistance;
+}
+
+//  hash( ... )
+//		splitmix64 folded over the size, the start, the exit and every
+//		word of the bitboard, 64 cells at a time.
+uint64_t DistanceField::hash(const Bitboard& open, Point start, Point exit) {
+	uint64_t h = ((uint64_t)(unsigned)open.rows() << 32) | (unsigned)open.cols();
+	h = Rng::splitmix(h);
+	h ^= ((uint64_t)(unsigned)start.getX() << 32) | (unsigned)start.getY();
+	h = Rng::splitmix(h);
+	h ^= ((uint64_t)(unsigned)exit.getX() << 32) | (unsigned)exit.getY();
+	h = Rng::splitmix(h);
+	for (int y = 0; y < open.rows(); y++) {
+		for (int w = 0; w < open.words(); w++) {
+			h ^= open.neighborWords(y, w).open;
+			h = Rng::splitmix(h);
+		}
+	}
+	return h;
+}
+
+
+// The field cache
+//
+
+namespace {
+
+struct CachedField {
+	uint64_t	hash;
+	uint64_t	lastUse;		// Tick of the last lookup, oldest is evicted
+	std::shared_ptr<const DistanceField> field;
+
+	// The maze itself, checked on every hit
+	int			rows;
+	int			cols;
+	Point		start;
+	Point		exit;
+	ArrayStack<uint64_t> cells;	// Open words of every row, as hash() reads them
+};
+
+std::mutex g_cacheLock;
+CachedField g_cache[FIELD_CACHE_SIZE];
+uint64_t g_cacheTick = 0;
+
+// Is c the field of this maze.  Different mazes can share a hash, so
+// a matching one is checked word for word, no more work than hashing.
+bool holds(const CachedField& c, uint64_t hash, const Bitboard& open, Point start, Point exit) {
+	if (!c.field || c.hash != hash || c.rows != open.rows() || c.cols != open.cols()
+		|| c.start != start || c.exit != exit)
+		return false;
+	int i = 0;
+	for (int y = 0; y < open.rows(); y++) {
+		for (int w = 0; w < open.words(); w++) {
+			if (c.cells[i++] != open.neighborWords(y, w).open)
+				return false;
+		}
+	}
+	return true;
+}
+
+// The cached field for this maze, null if there is none.  Caller
+// holds the lock.
+std::shared_ptr<const DistanceField> lookup(uint64_t hash, const Bitboard& open, Point start, Point exit) {
+	for (int i = 0; i < FIELD_CACHE_SIZE; i++) {
+		if (holds(g_cache[i], hash, open, start, exit)) {
+			g_cache[i].lastUse = ++g_cacheTick;
+			return g_cache[i].field;
+		}
+	}
+	return std::shared_ptr<const DistanceField>();
+}
+
+}
+
+//  cached( ... )
+//		Built outside the lock so other mazes are not held up.  Two
+//		threads missing on the same maze at once both build it, the
+//		first one stored wins.
+std::shared_ptr<const DistanceField> DistanceField::cached(const Bitboard& open, Point start, Point exit) {
+	uint64_t key = hash(open, start, exit);
+	{
+		std::lock_guard<std::mutex> lock(g_cacheLock);
+		std::shared_ptr<const DistanceField> field = lookup(key, open, start, exit);
+		if (field)
+			return field;
+	}
+
+	std::shared_ptr<const DistanceField> built = std::make_shared<DistanceField>(open, start, exit);
+
+	std::lock_guard<std::mutex> lock(g_cacheLock);
+	std::shared_ptr<const DistanceField> field = lookup(key, open, start, exit);
+	if (field)
+		return field;
+	int oldest = 0;
+	for (int i = 1; i < FIELD_CACHE_SIZE; i++) {
+		if (g_cache[i].lastUse < g_cache[oldest].lastUse)
+			oldest = i;
+	}
+	CachedField& c = g_cache[oldest];
+	c.hash = key;
+	c.lastUse = ++g_cacheTick;
+	c.field = built;
+	c.rows = open.rows();
+	c.cols = open.cols();
+	c.start = start;
+	c.exit = exit;
+	c.cells.clear();
+	c.cells.reserve(open.rows() * open.words());
+	for (int y = 0; y < open.rows(); y++)
+		for (int w = 0; w < open.words(); w++)
+			c.cells.push(open.neighborWords(y, w).open);
+	return built;
+}
+
+void DistanceField::clearCache() {
+	std::lock_guard<std::mutex> lock(g_cacheLock);
+	for (int i = 0; i < FIELD_CACHE_SIZE; i++) {
+		g_cache[i].field.reset();
+		g_cache[i].lastUse = 0;
+		ArrayStack<uint64_t>().swap(g_cache[i].cells);
+	}
+}
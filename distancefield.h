@@ -0,0 +1,74 @@
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include<cstdint>
+#include<memory>
+#include"point.h"
+#include"bitboard.h"
+#include"packedpath.h"
+
+// Steps from every cell of a maze to its exit, found by one breadth
+// first search out of the exit.
+//
+// Afterwards how far any cell is from the exit is a lookup, and a
+// shortest route from it is a greedy walk downhill: each step goes to
+// a neighbour one closer, O(route length) with no search at all.
+//
+// The field covers the open cells and the start, which is not open
+// but leads into them.  Rock and cells with no way to the exit are -1.
+class DistanceField {
+public:
+	DistanceField(const Bitboard& open, Point start, Point exit);
+	~DistanceField();
+
+	// Steps to the exit, -1 for rock, outside or no way out
+	int		distance(Point p) const;
+
+	// Shortest route from p to the exit.  False, path left empty at
+	// p, if there is none.
+	bool	route(Point p, PackedPath& path) const;
+
+	// The neighbour direction (PATH_W ... PATH_S) one step closer to
+	// the exit, -1 at the exit or where there is no way out.  Ties go
+	// W, E, N, S like the searches.
+	int		downhill(Point p) const;
+
+	Point	exit() const;
+	int		rows() const;
+	int		cols() const;
+	int		reachable() const;		// Cells with a distance, the exit included
+	int		maxDistance() const;	// Farthest reachable cell
+
+	// Hash of the maze a field would be built for: the open cells, the
+	// start and the exit.  Equal mazes hash equal.
+	static uint64_t hash(const Bitboard& open, Point start, Point exit);
+
+	// The field for this maze, built on the first call and shared by
+	// everyone asking for the same maze afterwards.  The most recent
+	// FIELD_CACHE_SIZE fields are kept, each with a copy of its maze's
+	// open cells so a hash collision is never taken for a hit.  Thread
+	// safe.
+	static std::shared_ptr<const DistanceField> cached(const Bitboard& open, Point start, Point exit);
+	// Drop every cached field, ones still held stay alive
+	static void	clearCache();
+
+private:
+	// Not copyable, owns the distances
+	DistanceField(const DistanceField& other);
+	DistanceField& operator=(const DistanceField& other);
+
+	int		index(Point p) const;
+	bool	inside(Point p) const;
+
+	int*	m_distance;		// [y * m_cols + x]
+	int		m_rows;
+	int		m_cols;
+	Point	m_exit;
+	Point	m_start;		// Has a distance but routes never pass through it
+	int		m_reachable;
+	int		m_maxDistance;
+};
+
+const int FIELD_CACHE_SIZE = 4;
+
+#endif//DISTANCEFIELD_H
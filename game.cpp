@@ -4,109 +4,109 @@
 #include"utils.h"
 #include <cstdlib>
 #include<iostream>
-#include <fstream>
 #include <sstream>
-#include<algorithm>
+#include <chrono>
 
 
-Game::Game(std::string settingsFile) :m_maxSteps(0), m_automate(false), m_showSteps(false) {
-	std::string fsettings = "settings.ini";
-	std::ifstream file(fsettings);
-
-	if (!file.is_open()) {
-		std::cerr << "ERROR Main: could not open file " << fsettings << ". Exiting." << std::endl;
-		std::cin.ignore(); exit(0);
+// Settings from file, exits on a bad one
+static Settings loadSettings(const std::string& settingsFile) {
+	Settings settings;
+	std::string error;
+	if (!settings.load(settingsFile, error)) {
+		std::cerr << "ERROR Main: " << error << "\n\tExiting." << std::endl;
+		std::cin.ignore(); exit(1);
 	}
-	//Grab settings from file
-	std::string line, setting, value;
-
-	std::string mazeFile = "maze_lecture.txt";
+	return settings;
+}
 
-	bool havePlayerBackTack = true; //Toggle player backtracking
+Game::Game(std::string settingsFile) :Game(loadSettings(settingsFile)) {
+}
 
-	int frameTimeDelay = 500;		//Effects game speed, shorter delay
-									//less time between frames, faster 
-									//simulation when automating.
-	int numSharks = 0;
+Game::Game(std::string filename, int numSharks, int delay, bool toggleBackTracking, RenderMode render)
+	:Game(makeSettings(filename, numSharks, toggleBackTracking)) {
+	m_delay = delay;
+	m_renderer = Renderer(render);
+}
 
-	while (std::getline(file, line)) {
-		line.erase(std::remove_if(line.begin(), line.end(),
-			[](char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }), line.end());
-		if (line.size() == 0) continue;
-		int delpos = line.find('=');
-		setting = line.substr(0, delpos);
-		value = line.substr(delpos + 1);
+Game::Game(std::string filename, int numSharks, bool toggleBackTracking, RunMode mode, SearchKind search)
+	:Game(makeSettings(filename, numSharks, toggleBackTracking)) {
+	m_automate = true;
+	m_headless = mode == RunMode::HEADLESS;
+	m_delay = 0;
+	m_aquarium->setPlayerSearch(search);
+}
 
-		if (setting == "mazeFile") {
-			std::ifstream tf(value);
+Game::Game(const Settings& settings) :Game(settings, makeAquarium(settings)) {
+}
 
-			if (!tf.is_open()) {
-				std::cerr << "ERROR Main: could not open file " << value << ". Exiting." << std::endl;
-				std::cin.ignore(); exit(0);
-			}
-			tf.close();
+Game::Game(const Settings& settings, Aquarium* aquarium)
+	:m_aquarium(aquarium), m_renderer(settings.render), m_automate(false), m_showSteps(false),
+	m_headless(settings.headless), m_maxSteps(0), m_delay(settings.frameTimeDelay),
+	m_mazeFile(settings.mazeName()), m_seed(settings.seed), m_numSharks(settings.numSharks),
+	m_metricsFile(settings.metricsFile), m_pathFile(settings.pathFile) {
 
-			mazeFile = value;
-		}
-		else if (setting == "havePlayerBackTack") {
-			if (value != "true" && value != "false") {
-				std::cerr << "ERROR Main: havePlayerBackTack setting incorrect format\n\tExpected: true/false, given: ." << value << ".\n\tExiting." << std::endl;;
-				std::cin.ignore(); exit(1);
-			}
+	m_aquarium->seed(settings.seed);
+	m_aquarium->setThreads(settings.numThreads);
 
-			std::istringstream istr(value);
-			istr >> std::boolalpha >> havePlayerBackTack;
-		}
-		else if (setting == "frameTimeDelay") {
-			frameTimeDelay = std::stoi(value);
-		}
-		else if (setting == "numSharks") {
-			numSharks = std::stoi(value);
-		}
-		else {
-			std::cerr << "ERROR Main: unknown setting " << setting << " " << value << ". Exiting." << std::endl;
-			std::cin.ignore(); exit(1);
-		}
-	}
-	file.close();
+	m_aquarium->setPlayerBackTracking(settings.havePlayerBackTack);
+	m_aquarium->setPlayerSearch(settings.search);
 
-	m_delay = frameTimeDelay;
+	m_aquarium->addSharks(settings.numSharks);
 
-	m_aquarium = new Aquarium(mazeFile);
+}
 
-	m_aquarium->setPlayerBackTracking(havePlayerBackTack);
+Game* Game::create(const Settings& settings, std::string& error) {
+	Aquarium* aquarium = makeAquarium(settings, error);
+	if (aquarium == nullptr)
+		return nullptr;
+	return new Game(settings, aquarium);
+}
 
-	// Arbitrarily set maximum number of sharks the half the number of open cells
-	int maxSharks = m_aquarium->numOpenCells() / 2;
-	if (numSharks > maxSharks) {
-		std::cerr << "ERROR GAME: too many sharks: " << numSharks
-			<< " for game size: " << maxSharks << ". Exiting." << std::endl;
-		exit(1);
+Aquarium* Game::makeAquarium(const Settings& settings, std::string& error) {
+	int64_t loadStart = metricsNow();
+	Aquarium* aquarium = nullptr;
+	if (settings.generateMaze) {
+		MazeSpec spec = settings.mazeSpec();
+		if (!MazeGenerator::validate(spec, error)) {
+			error = "cannot generate maze: " + error;
+			return nullptr;
+		}
+		std::string maze = MazeGenerator::text(spec);
+		aquarium = Aquarium::create(maze.data(), maze.size(), error);
 	}
+	else
+		aquarium = Aquarium::create(settings.mazeFile, error);
+	if (aquarium == nullptr)
+		return nullptr;
+	aquarium->metrics().record(Phase::LOAD, (uint64_t)(metricsNow() - loadStart));
 
-	for (int i = 0; i < numSharks; i++) {
-		m_aquarium->addSharks();
+	// Arbitrarily set maximum number of sharks the half the number of open cells
+	int maxSharks = aquarium->numOpenCells() / 2;
+	if (settings.numSharks > maxSharks) {
+		error = "too many sharks: " + std::to_string(settings.numSharks)
+			+ " for game size: " + std::to_string(maxSharks);
+		delete aquarium;
+		return nullptr;
 	}
-
+	return aquarium;
 }
-Game::Game(std::string filename, int numSharks, int delay, bool toggleBackTracking)
-	:m_maxSteps(0), m_automate(false), m_delay(delay) {
-
-	m_aquarium = new Aquarium(filename);
 
-	m_aquarium->setPlayerBackTracking(toggleBackTracking);
-	// Arbitrarily set maximum number of sharks the half the number of open cells
-	int maxSharks = m_aquarium->numOpenCells() / 2;
-	if (numSharks > maxSharks) {
-		std::cerr << "ERROR GAME: too many sharks: " << numSharks
-			<< " for game size: " << maxSharks << ". Exiting." << std::endl;
+Aquarium* Game::makeAquarium(const Settings& settings) {
+	std::string error;
+	Aquarium* aquarium = makeAquarium(settings, error);
+	if (aquarium == nullptr) {
+		std::cerr << "ERROR GAME: " << error << ". Exiting." << std::endl;
 		exit(1);
 	}
+	return aquarium;
+}
 
-	for (int i = 0; i < numSharks; i++) {
-		m_aquarium->addSharks();
-	}
-
+Settings Game::makeSettings(std::string filename, int numSharks, bool toggleBackTracking) {
+	Settings settings;
+	settings.mazeFile = filename;
+	settings.numSharks = numSharks;
+	settings.havePlayerBackTack = toggleBackTracking;
+	return settings;
 }
 
 Game::~Game() {
@@ -115,23 +115,45 @@ Game::~Game() {
 }
 
 void Game::play() {
+	if (m_headless) {
+		GameResult result = runHeadless();
+		std::cout << "Outcome: " << result.outcome
+			<< ", Steps: " << result.steps
+			<< ", Wall time: " << result.seconds << " s"
+			<< ", Steps/s: " << (result.seconds > 0 ? result.steps / result.seconds : 0) << std::endl;
+		reportSearch();
+		writeMetrics();
+		writePath();
+		return;
+	}
+
 	// Game loop
 	while (true) {
 
-		// Clear the canvas to draw new scene
-		clearScreen();
+		// Compose the new scene and put it on screen in one write,
+		// the renderer takes care of clearing the canvas
+		std::string& frame = m_renderer.beginFrame();
 
 		m_maxSteps++;
-		if (m_showSteps)
-			std::cout << "Step: " << m_maxSteps
+		if (m_showSteps) {
+			const LatencyHistogram& update = m_aquarium->metrics().phase(Phase::PLAYER_UPDATE);
+			std::ostringstream status;
+			status << "Step: " << m_maxSteps
 			<< ", Total Player::Update Runtime: " << m_aquarium->getPlayerUpdateRunTime()
-			<< ", Runtime/Step: " << m_aquarium->getPlayerUpdateRunTime() / m_maxSteps << std::endl;
+			<< ", Runtime/Step: " << m_aquarium->getPlayerUpdateRunTime() / m_maxSteps
+			<< ", p99: " << update.percentile(0.99) << ", Max: " << update.max() << '\n';
+			frame += status.str();
+		}
 
-		m_aquarium->draw();
+		m_aquarium->draw(frame);
+		m_renderer.present();
 
 
 		if (m_aquarium->player()->stuck()) {
 			std::cout << "Got stuck with no way out :( " << std::endl;
+			reportSearch();
+			writeMetrics();
+			writePath();
 			std::cout << "Press enter to continue.";
 			std::cin.ignore(10000, '\n');
 			return;
@@ -139,6 +161,9 @@ void Game::play() {
 
 		if (m_aquarium->player()->foundExit()) {
 			std::cout << "You've reached the end! Congratulations! " << std::endl;
+			reportSearch();
+			writeMetrics();
+			writePath();
 			std::cout << "Press enter to continue.";
 			std::cin.ignore(10000, '\n');
 			return;
@@ -156,6 +181,7 @@ void Game::play() {
 				continue;
 			case 'q':
 				std::cout << "Quitting Game." << std::endl;
+				writeMetrics();
 				return;
 			case ' ':
 				break;
@@ -170,6 +196,7 @@ void Game::play() {
 		else {
 			if (m_maxSteps >= MAX_STEPS) {
 				std::cout << "Reached max steps, quitting." << std::endl;
+				writeMetrics();
 				return;
 			}
 			delay(m_delay);
@@ -179,4 +206,86 @@ void Game::play() {
 		m_aquarium->interact();
 
 	}
+}
+
+GameResult Game::runHeadless() {
+	Player* player = m_aquarium->player();
+
+	// No way from the start to the exit, nothing to play out
+	bool hopeless = !m_aquarium->solvable();
+
+	auto t1 = std::chrono::steady_clock::now();
+	while (!hopeless && !player->stuck() && !player->foundExit() && m_maxSteps < MAX_STEPS) {
+		PhaseTimer step(m_aquarium->metrics(), Phase::STEP);
+		m_aquarium->update();
+		m_aquarium->interact();
+		m_maxSteps++;
+	}
+	auto t2 = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(t2 - t1).count();
+	collectCounters();
+
+	const char* outcome = "MAX_STEPS";
+	if (hopeless)
+		outcome = "UNSOLVABLE";
+	else if (player->foundExit())
+		outcome = "FREEDOM";
+	else if (player->stuck())
+		outcome = "STUCK";
+
+	GameResult result;
+	result.mazeFile = m_mazeFile;
+	result.search = player->getSearch();
+	result.seed = m_seed;
+	result.numSharks = m_numSharks;
+	result.outcome = outcome;
+	result.steps = m_maxSteps;
+	result.seconds = seconds;
+	result.nodesExpanded = player->nodesExpanded();
+	result.stepsTaken = player->stepsTaken();
+	return result;
+}
+
+void Game::reportSearch() const {
+	Player* player = m_aquarium->player();
+	std::cout << "Search: " << searchKindName(player->getSearch())
+		<< ", Nodes expanded: " << player->nodesExpanded()
+		<< ", Steps taken: " << player->stepsTaken() << std::endl;
+}
+
+void Game::collectCounters() {
+	Player* player = m_aquarium->player();
+	Metrics& metrics = m_aquarium->metrics();
+	metrics.set(Counter::STEPS, m_maxSteps);
+	metrics.set(Counter::CELLS_DISCOVERED, player->cellsDiscovered());
+	metrics.set(Counter::NODES_EXPANDED, player->nodesExpanded());
+	metrics.set(Counter::FRONTIER_HIGH_WATER, player->frontierHighWater());
+	metrics.set(Counter::BACKTRACK_HIGH_WATER, player->backtrackHighWater());
+	metrics.set(Counter::ALLOCATIONS, player->allocations());
+}
+
+void Game::writeMetrics() {
+	if (m_metricsFile.empty())
+		return;
+	collectCounters();
+	std::string error;
+	if (!m_aquarium->metrics().write(m_metricsFile, error))
+		std::cerr << "ERROR GAME: " << error << "." << std::endl;
+	else
+		std::cout << "Metrics written to " << m_metricsFile << std::endl;
+}
+
+void Game::writePath() {
+	if (m_pathFile.empty())
+		return;
+	PackedPath path;
+	if (!m_aquarium->player()->path(path)) {
+		std::cout << "No route to the exit was found, " << m_pathFile << " not written" << std::endl;
+		return;
+	}
+	std::string error;
+	if (!path.write(m_pathFile, error))
+		std::cerr << "ERROR GAME: " << error << "." << std::endl;
+	else
+		std::cout << "Route of " << path.size() << " steps written to " << m_pathFile << std::endl;
 }
\ No newline at end of file
@@ -2,27 +2,94 @@
 #define GAME_H
 
 #include<string>
+#include<cstdint>
+#include"search.h"
+#include"renderer.h"
+#include"settings.h"
 
 class Aquarium;
 
 const int MAX_STEPS = 100000;
 
+// How the game loop runs: drawing every frame and waiting on the user,
+// or with no terminal I/O at all as fast as the CPU allows
+enum class RunMode { INTERACTIVE, HEADLESS };
+
+// What a headless run came to
+struct GameResult {
+	std::string mazeFile;
+	SearchKind	search;
+	uint64_t	seed;
+	int			numSharks;
+	const char* outcome;		// "FREEDOM", "STUCK", "MAX_STEPS",
+								// "UNSOLVABLE" when the exit is walled off, or
+								// "ERROR" when the game could not be set up
+	std::string error;			// Why, for "ERROR"
+	int			steps;			// Game loop iterations
+	double		seconds;		// Wall time of the loop
+	int			nodesExpanded;
+	int			stepsTaken;		// Player moves
+};
+
 class Game {
 public:
 	// Dynamically allocates an aquarium and adds sharks
 	Game(std::string settingsFile);
-	Game(std::string filename, int numSharks, int delay, bool toggleBackTracking);
+	// Does not touch any process wide state, so several can run at
+	// once on different threads as long as they stay headless
+	Game(const Settings& settings);
+	Game(std::string filename, int numSharks, int delay, bool toggleBackTracking,
+		RenderMode render = RenderMode::FULL);
+	Game(std::string filename, int numSharks, bool toggleBackTracking, RunMode mode,
+		SearchKind search = SearchKind::DFS);
 	~Game();
 
+	// Same as Game(settings) but nullptr with error set on a bad maze,
+	// generator or shark count instead of exiting
+	static Game* create(const Settings& settings, std::string& error);
+
 	//Game loop
 	void play();
+
+	// Game loop without drawing, input or delays.  Runs until the
+	// player is free, stuck or MAX_STEPS is hit.  Mazes with no way
+	// out are not played at all.  Prints nothing.
+	GameResult runHeadless();
 private:
+	// Takes ownership of an aquarium from makeAquarium()
+	Game(const Settings& settings, Aquarium* aquarium);
+
+	static Settings makeSettings(std::string filename, int numSharks, bool toggleBackTracking);
+
+	// Load or generate the maze and check the shark count against it,
+	// nullptr with error set if any of that fails
+	static Aquarium* makeAquarium(const Settings& settings, std::string& error);
+	// Same, exits on failure
+	static Aquarium* makeAquarium(const Settings& settings);
+
+	// Print which search the player used and what it cost
+	void reportSearch() const;
+	// Copy the player's counters into the aquarium's metrics
+	void collectCounters();
+	// Write the metrics to m_metricsFile, if there is one
+	void writeMetrics();
+	// Write the player's route to m_pathFile, if there is one
+	void writePath();
+
 	Aquarium* m_aquarium;
+	Renderer	m_renderer;
 	bool		m_automate;
 	bool		m_showSteps;
+	bool		m_headless;
 	int			m_maxSteps;
 	int			m_delay;
 
+	std::string m_mazeFile;		// Kept for the GameResult
+	uint64_t	m_seed;
+	int			m_numSharks;
+	std::string m_metricsFile;
+	std::string m_pathFile;
+
 };
 
 #endif//GAME_H
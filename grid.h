@@ -0,0 +1,41 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include"point.h"
+
+// Row-major view over a rows x cols block of chars.
+// Cell (x, y) lives at data[y * cols + x], so walking a row walks
+// contiguous memory.  Grid does not own the memory it points to, the
+// owner (Aquarium) allocates and frees the block.
+//
+// The accessors are defined here so they inline at every call site.
+class Grid {
+public:
+	Grid() :m_data(nullptr), m_rows(0), m_cols(0) {}
+	Grid(char* data, int rows, int cols) :m_data(data), m_rows(rows), m_cols(cols) {}
+
+	// Will make use of implicit copy constructor and assignment operators,
+	// copying a Grid copies the view not the cells.
+
+	char&		at(int x, int y) { return m_data[y * m_cols + x]; }
+	char		at(int x, int y) const { return m_data[y * m_cols + x]; }
+	char&		at(const Point& p) { return at(p.getX(), p.getY()); }
+	char		at(const Point& p) const { return at(p.getX(), p.getY()); }
+
+	char*		row(int y) { return m_data + y * m_cols; }
+	const char* row(int y) const { return m_data + y * m_cols; }
+
+	char*		data() { return m_data; }
+	const char* data() const { return m_data; }
+
+	int			rows() const { return m_rows; }
+	int			cols() const { return m_cols; }
+	int			size() const { return m_rows * m_cols; }	// In cells (bytes)
+
+private:
+	char*	m_data;
+	int		m_rows;
+	int		m_cols;
+};
+
+#endif//GRID_H
@@ -0,0 +1,226 @@
+#include"jumppoint.h"
+#include<utility>
+
+static const int DX[4] = { -1, 1, 0, 0 };
+static const int DY[4] = { 0, 0, -1, 1 };
+
+// m_arrival of the start, every direction is open to it
+static const unsigned char ARRIVE_ANY = 4;
+
+static bool horizontal(int dir) {
+	return dir == PATH_W || dir == PATH_E;
+}
+
+JumpPointSearch::JumpPointSearch(const Bitboard& open)
+	:m_open(open), m_rows(open.rows()), m_cols(open.cols()), m_goal(),
+	m_heap(), m_seen(open.rows(), open.cols()), m_closed(open.rows(), open.cols()),
+	m_g(new int[open.rows() * open.cols()]), m_parent(new int[open.rows() * open.cols()]),
+	m_arrival(new unsigned char[open.rows() * open.cols()]),
+	m_expanded(0), m_jumpPoints(0), m_scanned(0) {
+}
+
+JumpPointSearch::~JumpPointSearch() {
+	delete[] m_g;
+	delete[] m_parent;
+	delete[] m_arrival;
+}
+
+int JumpPointSearch::nodesExpanded() const {
+	return m_expanded;
+}
+int JumpPointSearch::jumpPoints() const {
+	return m_jumpPoints;
+}
+long long JumpPointSearch::cellsScanned() const {
+	return m_scanned;
+}
+int JumpPointSearch::allocations() const {
+	return m_heap.allocations();
+}
+
+bool JumpPointSearch::open(int x, int y) const {
+	return m_open.test(x, y);
+}
+
+//  jumpHorizontal( ... )
+//		Every cell of a horizontal run may turn up or down, so each one
+//		looks along its column.  The cell is a jump point if either look
+//		finds one, the columns themselves are searched when it is
+//		expanded.
+int JumpPointSearch::jumpHorizontal(int x, int y, int dx) {
+	while (true) {
+		x += dx;
+		m_scanned++;
+		if (!open(x, y))
+			return -1;
+		if (m_goal.getX() == x && m_goal.getY() == y)
+			return y * m_cols + x;
+		if (jumpVertical(x, y, -1) >= 0 || jumpVertical(x, y, 1) >= 0)
+			return y * m_cols + x;
+	}
+}
+
+//  jumpVertical( ... )
+//		A vertical run only turns where a wall beside it ends: the cell
+//		to the side is open but the one behind it was not, so no
+//		horizontal first route could have got there.
+int JumpPointSearch::jumpVertical(int x, int y, int dy) {
+	while (true) {
+		y += dy;
+		m_scanned++;
+		if (!open(x, y))
+			return -1;
+		if (m_goal.getX() == x && m_goal.getY() == y)
+			return y * m_cols + x;
+		if ((open(x - 1, y) && !open(x - 1, y - dy)) || (open(x + 1, y) && !open(x + 1, y - dy)))
+			return y * m_cols + x;
+	}
+}
+
+// Manhattan distance to the goal
+int JumpPointSearch::heuristic(int cell) const {
+	int dx = cell % m_cols - m_goal.getX();
+	int dy = cell / m_cols - m_goal.getY();
+	return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+}
+
+int JumpPointSearch::jump(int x, int y, int dir) {
+	return horizontal(dir) ? jumpHorizontal(x, y, DX[dir]) : jumpVertical(x, y, DY[dir]);
+}
+
+//  reach( ... )
+//		Like A*, a jump point found again by a shorter route is pushed
+//		again and the old entry goes stale.  At equal length a
+//		horizontal arrival replaces a vertical one, it turns more ways.
+void JumpPointSearch::reach(int cell, int from, int g, int dir) {
+	Point p(cell % m_cols, cell / m_cols);
+	if (m_closed.test(p))
+		return;
+	if (m_seen.testAndSet(p)) {
+		if (g > m_g[cell])
+			return;
+		if (g == m_g[cell] && (!horizontal(dir) || horizontal(m_arrival[cell])))
+			return;
+	}
+	m_g[cell] = g;
+	m_parent[cell] = from;
+	m_arrival[cell] = (unsigned char)dir;
+	int h = heuristic(cell);
+	Entry e = { g + h, h, g, cell };
+	heapPush(e);
+	m_jumpPoints++;
+}
+
+//  solve( ... )
+//		A* over jump points.  The start turns every way, a horizontal
+//		arrival carries on or turns up or down, a vertical one carries
+//		on or turns where it was forced to.
+int JumpPointSearch::solve(Point start, Point end, PackedPath* path) {
+	m_heap.clear();
+	m_seen.reset();
+	m_closed.reset();
+	m_expanded = 0;
+	m_jumpPoints = 0;
+	m_scanned = 0;
+	m_goal = end;
+	if (path != nullptr)
+		path->clear(start);
+
+	if ((unsigned)start.getX() >= (unsigned)m_cols || (unsigned)start.getY() >= (unsigned)m_rows ||
+		!open(end.getX(), end.getY()))
+		return start == end ? 0 : -1;
+
+	int source = start.getY() * m_cols + start.getX();
+	int target = end.getY() * m_cols + end.getX();
+	m_seen.set(start);
+	m_g[source] = 0;
+	m_parent[source] = source;
+	m_arrival[source] = ARRIVE_ANY;
+	Entry first = { heuristic(source), heuristic(source), 0, source };
+	heapPush(first);
+	m_jumpPoints++;
+
+	int distance = -1;
+	while (!m_heap.empty()) {
+		Entry e = m_heap[0];
+		heapPop();
+		Point p(e.cell % m_cols, e.cell / m_cols);
+		if (m_closed.test(p) || e.g > m_g[e.cell])
+			continue;
+		m_closed.set(p);
+		m_expanded++;
+		if (e.cell == target) {
+			distance = e.g;
+			break;
+		}
+
+		int x = p.getX(), y = p.getY();
+		int arrival = m_arrival[e.cell];
+		for (int d = 0; d < 4; d++) {
+			if (arrival != ARRIVE_ANY && d == (arrival ^ 1))
+				continue;	// Never straight back
+			if (arrival != ARRIVE_ANY && !horizontal(arrival) && horizontal(d)) {
+				// Off a vertical run only where forced
+				int behind = y - DY[arrival];
+				if (!open(x + DX[d], y) || open(x + DX[d], behind))
+					continue;
+			}
+			int next = jump(x, y, d);
+			if (next < 0)
+				continue;
+			int steps = horizontal(d) ? next % m_cols - x : next / m_cols - y;
+			reach(next, e.cell, e.g + (steps < 0 ? -steps : steps), d);
+		}
+	}
+
+	// Every jump point is in a straight line from its parent, fill the
+	// runs in from the back
+	if (path != nullptr && distance >= 0) {
+		path->resize(distance);
+		int i = distance;
+		for (int cell = target; cell != source; cell = m_parent[cell]) {
+			int from = m_parent[cell];
+			int dx = cell % m_cols - from % m_cols;
+			int dy = cell / m_cols - from / m_cols;
+			int dir = dx < 0 ? PATH_W : dx > 0 ? PATH_E : dy < 0 ? PATH_N : PATH_S;
+			int steps = dx + dy < 0 ? -(dx + dy) : dx + dy;
+			for (int s = 0; s < steps; s++)
+				path->set(--i, dir);
+		}
+	}
+	return distance;
+}
+
+bool JumpPointSearch::before(const Entry& a, const Entry& b) {
+	if (a.f != b.f) return a.f < b.f;
+	return a.h < b.h;
+}
+
+void JumpPointSearch::heapPush(const Entry& e) {
+	m_heap.push(e);
+	int i = m_heap.size() - 1;
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!before(m_heap[i], m_heap[parent]))
+			break;
+		std::swap(m_heap[i], m_heap[parent]);
+		i = parent;
+	}
+}
+
+void JumpPointSearch::heapPop() {
+	int n = m_heap.size() - 1;
+	m_heap[0] = m_heap[n];
+	m_heap.pop();
+	int i = 0;
+	while (true) {
+		int best = i;
+		int l = 2 * i + 1, r = l + 1;
+		if (l < n && before(m_heap[l], m_heap[best])) best = l;
+		if (r < n && before(m_heap[r], m_heap[best])) best = r;
+		if (best == i)
+			break;
+		std::swap(m_heap[i], m_heap[best]);
+		i = best;
+	}
+}
@@ -0,0 +1,84 @@
+#ifndef JUMPPOINT_H
+#define JUMPPOINT_H
+
+#include"point.h"
+#include"bitboard.h"
+#include"visited.h"
+#include"arraystack.h"
+#include"packedpath.h"
+
+// Jump point search (JPS4) on the 4-connected, uniform cost aquarium.
+//
+// Of the many equally short routes through an open room, only the one
+// that goes horizontally first is searched.  Along a horizontal run
+// every cell looks up and down; along a vertical run nothing turns off
+// unless a wall beside the run just ended (a forced neighbour).  The
+// run is followed without expanding anything until one of those
+// happens, so A* only expands the jump points where routes can turn,
+// not every cell of the room.  Routes are as short as any other
+// search's.
+//
+// Still touches cells while jumping, cellsScanned() counts them next
+// to nodesExpanded() for an honest comparison.
+class JumpPointSearch {
+public:
+	// open must outlive the search
+	JumpPointSearch(const Bitboard& open);
+	~JumpPointSearch();
+
+	// Steps from start to end, -1 if end cannot be reached.  The start
+	// cell need not be open, it is never passed through.  With a path,
+	// fills it start to end.
+	int		solve(Point start, Point end, PackedPath* path = nullptr);
+
+	// Cost of the last solve()
+	int		nodesExpanded() const;	// Jump points taken off the heap
+	int		jumpPoints() const;		// Jump points pushed onto the heap
+	long long cellsScanned() const;	// Cells looked at while jumping
+	int		allocations() const;	// Times the heap grew, over every solve()
+
+private:
+	// Not copyable
+	JumpPointSearch(const JumpPointSearch& other);
+	JumpPointSearch& operator=(const JumpPointSearch& other);
+
+	struct Entry {
+		int			f;		// g + h
+		int			h;		// Manhattan distance to the goal
+		int			g;		// Steps from the start when pushed
+		int			cell;
+	};
+
+	// Does a belong above b in the heap
+	static bool	before(const Entry& a, const Entry& b);
+	void		heapPush(const Entry& e);
+	void		heapPop();
+
+	bool		open(int x, int y) const;
+	int			heuristic(int cell) const;
+	// Next jump point from (x, y) going dir (PATH_W ... PATH_S), -1 if
+	// the run hits a wall first
+	int			jump(int x, int y, int dir);
+	int			jumpHorizontal(int x, int y, int dx);
+	int			jumpVertical(int x, int y, int dy);
+	// Open a jump point reached going dir from the jump point at from
+	void		reach(int cell, int from, int g, int dir);
+
+	const Bitboard& m_open;
+	int			m_rows;
+	int			m_cols;
+	Point		m_goal;
+
+	ArrayStack<Entry> m_heap;	// Binary min-heap, ArrayStack for the storage
+	VisitedSet	m_seen;			// Jump points with a g
+	VisitedSet	m_closed;		// Jump points expanded
+	int*		m_g;			// Best known steps from the start, valid if seen
+	int*		m_parent;		// Jump point each was reached from
+	unsigned char* m_arrival;	// Direction it was reached going, ARRIVE_ANY for the start
+
+	int			m_expanded;
+	int			m_jumpPoints;
+	long long	m_scanned;
+};
+
+#endif//JUMPPOINT_H
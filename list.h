@@ -3,20 +3,30 @@
 
 #include<iostream>
 #include<assert.h>
+#include<new>
+#include<iterator>
+#include<type_traits>
+#include<utility>
+#include"nodepool.h"
 using namespace std;
 // Linked List object that maintains both head and tail pointers
 // and the size of the list.  Note that you have to keep the head,
 // tail and size consistent with the intended state of the List 
 // otherwise very bad things happen. 
-template<typename Type>
+//
+// Nodes come from the Alloc policy (see nodepool.h), by default a
+// per-list slab pool so pushing and popping rarely reaches the heap.
+template<typename Type, template<typename> class Alloc = NodePool>
 class List {
 public:
 
 	List();
 
-	List(const List<Type>& other);
+	List(const List<Type, Alloc>& other);
+	List(List<Type, Alloc>&& other);
 
-	List<Type>& operator=(const List<Type>& other);
+	List<Type, Alloc>& operator=(const List<Type, Alloc>& other);
+	List<Type, Alloc>& operator=(List<Type, Alloc>&& other);
 
 	~List();
 
@@ -24,14 +34,22 @@ public:
 	bool	empty() const;
 
 	void	push_front(const Type& item);
+	void	push_front(Type&& item);
 	void	push_back(const Type& item);
+	void	push_back(Type&& item);
 	void	add(int index, const Type& item);
 
+	// Construct the item in place from args
+	template<typename... Args>
+	void	emplace_front(Args&&... args);
+	template<typename... Args>
+	void	emplace_back(Args&&... args);
+
 	// Note that the user must first ensure the list is not empty
 	// prior to calling these functions.
-	Type	front() const;
-	Type	rear() const;
-	Type	get_at(int index) const;
+	const Type&	front() const;
+	const Type&	rear() const;
+	const Type&	get_at(int index) const;
 
 	int		size() const;
 	int		find(const Type& item) const;
@@ -45,6 +63,18 @@ public:
 // member functions
 	class Node;
 
+	// Bidirectional iterators, for range-for and <algorithm>.
+	// Walking the whole list this way is linear, unlike get_at(i).
+	template<typename Value>
+	class Iterator;
+	typedef Iterator<Type>			iterator;
+	typedef Iterator<const Type>	const_iterator;
+
+	iterator		begin();
+	iterator		end();
+	const_iterator	begin() const;
+	const_iterator	end() const;
+
 	// We'll have both head and tail points for 
 	// Fast insertion/deletion from both ends.
 	Node* m_head;
@@ -53,10 +83,23 @@ public:
 	// Keep track of size of list
 	int		m_size;
 
+	// Node allocator, its counters show the node churn
+	const Alloc<Node>& allocator() const;
+
 #ifndef MAKE_MEMBERS_PUBLIC
 private:
 #endif
 
+	// Construct/destroy a single node through m_alloc
+	template<typename... Args>
+	Node*	createNode(Args&&... args);
+	void	destroyNode(Node* n);
+
+	// Destroy every node and give all memory back to m_alloc
+	void	destroyAll();
+
+	Alloc<Node> m_alloc;
+
 };
 
 
@@ -72,24 +115,77 @@ private:
 
 // Node definition
 //		Already implemented, nothing to do here but to use it.
-template<typename Type>
-class List<Type>::Node {
+template<typename Type, template<typename> class Alloc>
+class List<Type, Alloc>::Node {
 public:
 	Node() :next(nullptr), prev(nullptr) {}
 	Node(Type item, Node* p, Node* n) : item(item), next(n), prev(p) {}
 
+	// Builds the item in place from args, used for emplace and moves
+	template<typename... Args>
+	Node(Node* p, Node* n, Args&&... args) : item(std::forward<Args>(args)...), next(n), prev(p) {}
+
 	Type  item;
 	Node* next;
 	Node* prev;
 };
 
+// Iterator definition
+//		Points at a Node, or past the end when m_node is null.  Keeps
+//		the list so --end() can step back onto the tail.
+template<typename Type, template<typename> class Alloc>
+template<typename Value>
+class List<Type, Alloc>::Iterator {
+public:
+	typedef std::bidirectional_iterator_tag	iterator_category;
+	typedef Type							value_type;
+	typedef std::ptrdiff_t					difference_type;
+	typedef Value*							pointer;
+	typedef Value&							reference;
+
+	Iterator() :m_node(nullptr), m_list(nullptr) {}
+	Iterator(Node* node, const List<Type, Alloc>* list) :m_node(node), m_list(list) {}
+
+	// iterator converts to const_iterator
+	operator Iterator<const Type>() const { return Iterator<const Type>(m_node, m_list); }
+
+	reference	operator*() const { return m_node->item; }
+	pointer		operator->() const { return &m_node->item; }
+
+	Iterator& operator++() {
+		m_node = m_node->next;
+		return *this;
+	}
+	Iterator operator++(int) {
+		Iterator old = *this;
+		m_node = m_node->next;
+		return old;
+	}
+	Iterator& operator--() {
+		m_node = (m_node == nullptr) ? m_list->m_tail : m_node->prev;
+		return *this;
+	}
+	Iterator operator--(int) {
+		Iterator old = *this;
+		--(*this);
+		return old;
+	}
+
+	bool operator==(const Iterator& other) const { return m_node == other.m_node; }
+	bool operator!=(const Iterator& other) const { return m_node != other.m_node; }
+
+private:
+	Node* m_node;
+	const List<Type, Alloc>* m_list;
+};
+
 
 
 // List default constructor
 //		Set head and tail pointer to point to nothing, size is zero
 //		Already implemented, nothing to do.
-template<typename Type>
-List<Type>::List() :m_head(nullptr), m_tail(nullptr), m_size(0) {
+template<typename Type, template<typename> class Alloc>
+List<Type, Alloc>::List() :m_head(nullptr), m_tail(nullptr), m_size(0) {
 }
 
 
@@ -98,8 +194,8 @@ List<Type>::List() :m_head(nullptr), m_tail(nullptr), m_size(0) {
 //		number of Nodes and the Values stored these Nodes in the same 
 //		order as seen the other lists Nodes.  This should not result 
 //		in any memory leaks or aliasing.  
-template<typename Type>
-List<Type>::List(const List<Type>& other) {
+template<typename Type, template<typename> class Alloc>
+List<Type, Alloc>::List(const List<Type, Alloc>& other) :m_head(nullptr), m_tail(nullptr), m_size(0) {
 	if (other.m_head == nullptr) {
 		m_head = m_tail = nullptr;
 	}
@@ -110,8 +206,7 @@ List<Type>::List(const List<Type>& other) {
 		Node* prev = nullptr;
 		for (int i = 0; i < m_size; i++)
 		{
-			Node* n = new Node;
-			n->item = p->item;
+			Node* n = createNode(p->item);
 			if (m_head == nullptr)
 			{
 				m_head = n;
@@ -130,21 +225,27 @@ List<Type>::List(const List<Type>& other) {
 	}
 }
 
+// Move constructor
+//		Takes over the other list's nodes, and the pool they live in,
+//		without copying anything.  The other list is left empty.
+template<typename Type, template<typename> class Alloc>
+List<Type, Alloc>::List(List<Type, Alloc>&& other)
+	:m_head(other.m_head), m_tail(other.m_tail), m_size(other.m_size) {
+	m_alloc.swap(other.m_alloc);
+	other.m_head = other.m_tail = nullptr;
+	other.m_size = 0;
+}
+
 // Overloaded assignment operator 
 //		Causes the already existing linked list to be identical to the 
 //		other linked list without causing any memory leaks or aliasing.
-template<typename Type>
-List<Type>& List<Type>::operator=(const List<Type>& other) {
+template<typename Type, template<typename> class Alloc>
+List<Type, Alloc>& List<Type, Alloc>::operator=(const List<Type, Alloc>& other) {
 	if (this == &other) {
 		return *this;
 	}
 	else {
-		Node* p = m_head;
-		while (p != nullptr) {
-			Node* n = p->next;
-			delete p;
-			p = n;
-		}
+		destroyAll();
 		m_head = nullptr;
 		m_tail = nullptr;
 		m_size = NULL;
@@ -158,8 +259,7 @@ List<Type>& List<Type>::operator=(const List<Type>& other) {
 			Node* prev = nullptr;
 			for (int i = 0; i < m_size; i++)
 			{
-				Node* n = new Node;
-				n->item = p->item;
+				Node* n = createNode(p->item);
 				if (m_head == nullptr)
 				{
 					m_head = n;
@@ -181,16 +281,28 @@ List<Type>& List<Type>::operator=(const List<Type>& other) {
 }
 
 
+// Move assignment operator
+//		Frees this list's nodes then takes over the other list's.
+template<typename Type, template<typename> class Alloc>
+List<Type, Alloc>& List<Type, Alloc>::operator=(List<Type, Alloc>&& other) {
+	if (this == &other) {
+		return *this;
+	}
+	destroyAll();
+	m_head = other.m_head;
+	m_tail = other.m_tail;
+	m_size = other.m_size;
+	m_alloc.swap(other.m_alloc);
+	other.m_head = other.m_tail = nullptr;
+	other.m_size = 0;
+	return *this;
+}
+
 // List destructor
 //		Traverses the nodes and deletes them without causing memory leaks
-template<typename Type>
-List<Type>::~List() {
-	Node* p = m_head;
-	while (p != nullptr) {
-		Node* n = p->next;
-		delete p;
-		p = n;
-	}
+template<typename Type, template<typename> class Alloc>
+List<Type, Alloc>::~List() {
+	destroyAll();
 	m_head = nullptr;
 	m_tail = nullptr;
 	m_size = NULL;
@@ -201,8 +313,8 @@ List<Type>::~List() {
 //		Assumes << is overloaded for object Type.
 //		
 
-template<typename Type>
-void List<Type>::print() const {
+template<typename Type, template<typename> class Alloc>
+void List<Type, Alloc>::print() const {
 	Node* p = m_head;
 	if (p != NULL) {
 		cout << p->item;
@@ -218,8 +330,8 @@ void List<Type>::print() const {
 // List empty
 //		returns true if there are no items in the list
 //		otherwise returns false.
-template<typename Type>
-bool List<Type>::empty() const {
+template<typename Type, template<typename> class Alloc>
+bool List<Type, Alloc>::empty() const {
 	if (m_head == nullptr) {
 		return true;
 	}
@@ -236,12 +348,25 @@ bool List<Type>::empty() const {
 //		Two cases to consider: If the list is empty 
 //		and if the list has items already it.
 //
-template<typename Type>
-void List<Type>::push_front(const Type& item) {
+template<typename Type, template<typename> class Alloc>
+void List<Type, Alloc>::push_front(const Type& item) {
+	emplace_front(item);
+}
+
+template<typename Type, template<typename> class Alloc>
+void List<Type, Alloc>::push_front(Type&& item) {
+	emplace_front(std::move(item));
+}
+
+// List emplace_front
+//		Same as push_front, but the item is constructed inside
+//		the new node from args.
+template<typename Type, template<typename> class Alloc>
+template<typename... Args>
+void List<Type, Alloc>::emplace_front(Args&&... args) {
 	//for no items in list
 	if (m_head == nullptr) {
-		Node* p = new Node;
-		p->item = item;
+		Node* p = createNode(std::forward<Args>(args)...);
 		p->next = nullptr;
 		p->prev = nullptr;
 		m_head = p;
@@ -250,8 +375,7 @@ void List<Type>::push_front(const Type& item) {
 	}
 	// for items already in list
 	else {
-		Node* p = new Node;
-		p->item = item;
+		Node* p = createNode(std::forward<Args>(args)...);
 		p->next = m_head;
 		m_head->prev = p;
 		p->prev = nullptr;
@@ -267,14 +391,27 @@ void List<Type>::push_front(const Type& item) {
 //		Two cases to consider: If the list is empty 
 //		and if the list has items already it.
 //
-template<typename Type>
-void List<Type>::push_back(const Type& item) {
+template<typename Type, template<typename> class Alloc>
+void List<Type, Alloc>::push_back(const Type& item) {
+	emplace_back(item);
+}
+
+template<typename Type, template<typename> class Alloc>
+void List<Type, Alloc>::push_back(Type&& item) {
+	emplace_back(std::move(item));
+}
+
+// List emplace_back
+//		Same as push_back, but the item is constructed inside
+//		the new node from args.
+template<typename Type, template<typename> class Alloc>
+template<typename... Args>
+void List<Type, Alloc>::emplace_back(Args&&... args) {
 	if (m_head == nullptr) {
-		push_front(item);
+		emplace_front(std::forward<Args>(args)...);
 	}
 	else {
-		Node* p = new Node;
-		p->item = item;
+		Node* p = createNode(std::forward<Args>(args)...);
 		m_tail->next = p;
 		p->next = nullptr;
 		p->prev = m_tail;
@@ -293,8 +430,8 @@ void List<Type>::push_back(const Type& item) {
 //		All other cases, add the item to the appropriate
 //			location
 //
-template<typename Type>
-void List<Type>::add(int index, const Type& item) {
+template<typename Type, template<typename> class Alloc>
+void List<Type, Alloc>::add(int index, const Type& item) {
 	if (index <= 0) {
 		push_front(item);
 	}
@@ -304,11 +441,10 @@ void List<Type>::add(int index, const Type& item) {
 	//test this more
 	else {
 		Node* t = m_head;
-		Node* p = new Node;
+		Node* p = createNode(item);
 		for (int i = 0; i < index - 1; i++) {
 			t = t->next;
 		}
-		p->item = item;
 		p->next = t->next;
 		p->prev = t;
 		t->next = p;
@@ -321,37 +457,37 @@ void List<Type>::add(int index, const Type& item) {
 // 8. List front
 //		returns the first item in the list.
 //
-template<typename Type>
-Type List<Type>::front() const {
+template<typename Type, template<typename> class Alloc>
+const Type& List<Type, Alloc>::front() const {
 	// Force check that the head is pointing to a Node
 	// Typical solution for deployement code is to throw
 	// exceptions, but since we haven't covered that yet
 	// we'll make due with assert, which is used for testing
 	assert(m_head != nullptr);
-	Type item;
 	return m_head->item;
 }
 
 // List rear
 //		returns the last item in the list
 //
-template<typename Type>
-Type List<Type>::rear() const {
+template<typename Type, template<typename> class Alloc>
+const Type& List<Type, Alloc>::rear() const {
 
 	// Force check that the tail is pointing to a Node
 	// Typical solution for deployement code is to throw
 	// exceptions, since we haven't covered that yet
 	// we'll make due with assert, which is used for testing
 	assert(m_tail != nullptr);
-	Type item;
 	return m_tail->item;
 }
 
 // List get_at
-//		returns the item at index
+//		returns the item at index, walking in from whichever
+//		end is closer.  Still O(n), iterate instead of calling
+//		this in a loop.
 //
-template<typename Type>
-Type List<Type>::get_at(int index) const {
+template<typename Type, template<typename> class Alloc>
+const Type& List<Type, Alloc>::get_at(int index) const {
 
 	// Force index to be correct before getting the Item
 	// Typical solution for deployement code is to throw
@@ -361,9 +497,18 @@ Type List<Type>::get_at(int index) const {
 	if (index <= 0) {
 		return front();
 	}
-	else if (index == m_size) {
+	else if (index == m_size - 1) {
 		return rear();
 	}
+	else if (index > m_size / 2) {
+		int i = m_size - 1;
+		Node* p = m_tail;
+		while (i > index) {
+			p = p->prev;
+			i--;
+		}
+		return p->item;
+	}
 	else {
 		int i = 0;
 		Node* p = m_head;
@@ -371,15 +516,14 @@ Type List<Type>::get_at(int index) const {
 			p = p->next;
 			i++;
 		}
-		Type item;
 		return p->item;
 	}
 }
 
 // List size
 //		return the size of the list
-template<typename Type>
-int List<Type>::size() const {
+template<typename Type, template<typename> class Alloc>
+int List<Type, Alloc>::size() const {
 	return m_size;
 }
 
@@ -389,8 +533,8 @@ int List<Type>::size() const {
 //		if it is return the index of that item, otherwise
 //		return -1. Assumes the == operator is overloaded for
 //		object Type.
-template<typename Type>
-int List<Type>::find(const Type& item) const {
+template<typename Type, template<typename> class Alloc>
+int List<Type, Alloc>::find(const Type& item) const {
 	Node* p = m_head;
 	int i = 0;
 	while (p != nullptr) {
@@ -402,9 +546,7 @@ int List<Type>::find(const Type& item) const {
 			i++;
 		}
 	}
-	if (i >= m_size) {
-		return -1;
-	}
+	return -1;
 }
 
 // List pop_front
@@ -415,8 +557,8 @@ int List<Type>::find(const Type& item) const {
 //		Must consider at least two cases where the list: is empty, 
 //		has one or more items.
 //		
-template<typename Type>
-bool List<Type>::pop_front() {
+template<typename Type, template<typename> class Alloc>
+bool List<Type, Alloc>::pop_front() {
 	if (m_head == nullptr) {
 		return false;
 	}
@@ -426,7 +568,7 @@ bool List<Type>::pop_front() {
 		m_tail = m_head;
 		d->prev = nullptr;
 		d->next = nullptr;
-		delete d;
+		destroyNode(d);
 		m_size--;
 		return true;
 	}
@@ -436,7 +578,7 @@ bool List<Type>::pop_front() {
 		m_head->prev = nullptr;
 		d->prev = nullptr;
 		d->next = nullptr;
-		delete d;
+		destroyNode(d);
 		m_size--;
 		return true;
 	}
@@ -449,19 +591,19 @@ bool List<Type>::pop_front() {
 //		Must consider at least three cases where the list: is empty, 
 //		has one item, has two or more items.
 //	
-template<typename Type>
-bool List<Type>::pop_rear() {
+template<typename Type, template<typename> class Alloc>
+bool List<Type, Alloc>::pop_rear() {
 	if (m_head == nullptr) {
 		return false;
 	}
 	else if (m_size == 1) {
-		pop_front();
+		return pop_front();
 	}
 	else {
 		Node* d = m_tail;
 		m_tail = d->prev;
 		m_tail->next = nullptr;
-		delete d;
+		destroyNode(d);
 		m_size--;
 		return true;
 	}
@@ -474,17 +616,17 @@ bool List<Type>::pop_rear() {
 //		head, tail, and size accordingly. If the index is
 //		out of bounds return false.
 //
-template<typename Type>
-bool List<Type>::pop_at(int index) {
+template<typename Type, template<typename> class Alloc>
+bool List<Type, Alloc>::pop_at(int index) {
 	if (index >= 0 && index < m_size) {
 		if (index == 0) {
-			pop_front();
+			return pop_front();
 		}
 		else if (index == m_size - 1) {
 			Node* d = m_tail;
 			m_tail = d->prev;
 			m_tail->next = nullptr;
-			delete d;
+			destroyNode(d);
 			m_size--;
 			return true;
 		}
@@ -500,7 +642,7 @@ bool List<Type>::pop_at(int index) {
 				p->next = d->next;
 				p = p->next;
 				p->prev = d->prev;
-				delete d;
+				destroyNode(d);
 				m_size--;
 				return true;
 			}
@@ -512,4 +654,64 @@ bool List<Type>::pop_at(int index) {
 	}
 }
 
+// List allocator
+//		The node allocator, for inspecting its counters
+template<typename Type, template<typename> class Alloc>
+const Alloc<typename List<Type, Alloc>::Node>& List<Type, Alloc>::allocator() const {
+	return m_alloc;
+}
+
+// List begin/end
+//		Iterators over the items front to rear, end is past the rear
+template<typename Type, template<typename> class Alloc>
+typename List<Type, Alloc>::iterator List<Type, Alloc>::begin() {
+	return iterator(m_head, this);
+}
+template<typename Type, template<typename> class Alloc>
+typename List<Type, Alloc>::iterator List<Type, Alloc>::end() {
+	return iterator(nullptr, this);
+}
+template<typename Type, template<typename> class Alloc>
+typename List<Type, Alloc>::const_iterator List<Type, Alloc>::begin() const {
+	return const_iterator(m_head, this);
+}
+template<typename Type, template<typename> class Alloc>
+typename List<Type, Alloc>::const_iterator List<Type, Alloc>::end() const {
+	return const_iterator(nullptr, this);
+}
+
+// List createNode
+//		Constructs a node, with its item built from args, in storage
+//		from the allocator
+template<typename Type, template<typename> class Alloc>
+template<typename... Args>
+typename List<Type, Alloc>::Node* List<Type, Alloc>::createNode(Args&&... args) {
+	return new (m_alloc.allocate()) Node(nullptr, nullptr, std::forward<Args>(args)...);
+}
+
+// List destroyNode
+//		Destroys a node and hands its storage back to the allocator
+template<typename Type, template<typename> class Alloc>
+void List<Type, Alloc>::destroyNode(Node* n) {
+	n->~Node();
+	m_alloc.deallocate(n);
+}
+
+// List destroyAll
+//		Frees every node.  When the items need no destructor and the
+//		allocator can free all its memory at once the nodes are not
+//		walked at all, the slabs are just released.
+template<typename Type, template<typename> class Alloc>
+void List<Type, Alloc>::destroyAll() {
+	if (!(std::is_trivially_destructible<Type>::value && m_alloc.releasesAll())) {
+		Node* p = m_head;
+		while (p != nullptr) {
+			Node* n = p->next;
+			destroyNode(p);
+			p = n;
+		}
+	}
+	m_alloc.release();
+}
+
 #endif
\ No newline at end of file
@@ -46,9 +46,59 @@ int main() {
 
 
 #include"game.h"
+#include"batch.h"
+#include"mazegen.h"
+#include<iostream>
+#include<string>
 
-int main() {
+int main(int argc, char** argv) {
+
+	// Game.exe --generate <kind> <rows> <cols> <seed> <out.txt> [density]
+	// Writes a generated maze to a file and quits
+	if (argc > 1 && std::string(argv[1]) == "--generate") {
+		// Parsed like the generateMaze settings
+		Settings settings;
+		std::string error;
+		bool ok = argc >= 7 && settings.apply(std::string("generateMaze=") + argv[2], error)
+			&& settings.apply(std::string("mazeRows=") + argv[3], error)
+			&& settings.apply(std::string("mazeCols=") + argv[4], error)
+			&& settings.apply(std::string("seed=") + argv[5], error)
+			&& (argc == 7 || settings.apply(std::string("obstacleDensity=") + argv[7], error));
+		if (!ok) {
+			if (error.size() > 0)
+				std::cerr << "ERROR Main: " << error << std::endl;
+			std::cerr << "Usage: " << argv[0] << " --generate <backtracker|prim|wilson|open> <rows> <cols> <seed> <out.txt> [density]" << std::endl;
+			return 1;
+		}
+		MazeSpec spec = settings.mazeSpec();
+		if (!MazeGenerator::validate(spec, error)) {
+			std::cerr << "ERROR Main: " << error << ". Exiting." << std::endl;
+			return 1;
+		}
+		if (!MazeGenerator::write(spec, argv[6])) {
+			std::cerr << "ERROR Main: could not write " << argv[6] << ". Exiting." << std::endl;
+			return 1;
+		}
+		return 0;
+	}
 
+	// Game.exe --batch mazes.txt report.csv [threads]
+	// Runs every maze in the list headless and writes one report
+	if (argc > 1 && std::string(argv[1]) == "--batch") {
+		if (argc < 4) {
+			std::cerr << "Usage: " << argv[0] << " --batch <maze list> <report.csv|report.json> [threads]" << std::endl;
+			return 1;
+		}
+		// Parsed like the numThreads setting
+		Settings threads;
+		threads.numThreads = 0;
+		std::string error;
+		if (argc > 4 && !threads.apply(std::string("numThreads=") + argv[4], error)) {
+			std::cerr << "Usage: " << argv[0] << " --batch <maze list> <report.csv|report.json> [threads]" << std::endl;
+			return 1;
+		}
+		return runBatch(argv[2], argv[3], "settings.ini", threads.numThreads);
+	}
 
 	//Setup game
 	Game g("settings.ini");
@@ -58,6 +108,269 @@ int main() {
 
 	return 0;
 }
+#elif defined(RUN03) //Benchmark the shark kernels
+
+#include"shark.h"
+#include"rng.h"
+#include"threadpool.h"
+#include<chrono>
+#include<iostream>
+
+// Time one kernel moving a school around an open aquarium with
+// random rocks, in nanoseconds per shark step
+template<typename Kernel>
+double timeSharks(SharkSchool& school, const bool* open, int rows, int cols, int steps, Kernel kernel) {
+	auto t1 = std::chrono::high_resolution_clock::now();
+	for (int s = 0; s < steps; s++)
+		kernel(school, open, rows, cols);
+	auto t2 = std::chrono::high_resolution_clock::now();
+	double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+	return ns / ((double)steps * school.size());
+}
+
+// Sharks that ended up somewhere else in b than in a
+int countMismatches(const SharkSchool& a, const SharkSchool& b) {
+	int mismatches = 0;
+	for (int i = 0; i < a.size(); i++)
+		if (a.x(i) != b.x(i) || a.y(i) != b.y(i))
+			mismatches++;
+	return mismatches;
+}
+
+int main() {
+
+	const int rows = 512, cols = 512, sharks = 100000, steps = 200;
+
+	// Fixed seed, every run times the same aquarium and school
+	Rng rng(20);
+
+	// A row of draws at a time, one in ten a rock
+	bool* open = new bool[rows * cols + SHARK_MASK_PAD]();
+	int* draws = new int[cols];
+	for (int y = 1; y < rows - 1; y++) {
+		rng.fill(draws, cols - 2, 0, 9);
+		for (int x = 1; x < cols - 1; x++)
+			open[y * cols + x] = draws[x - 1] != 0;
+	}
+	delete[] draws;
+
+	SharkSchool scalar;
+	scalar.setSeed(rng.nextU32());
+	for (int i = 0; i < sharks; i++) {
+		int x, y;
+		do {
+			x = rng.nextInt(1, cols - 2);
+			y = rng.nextInt(1, rows - 2);
+		} while (!open[y * cols + x]);
+		scalar.add(Point(x, y));
+	}
+	SharkSchool start(scalar);
+	SharkSchool wide(scalar);
+
+	double scalarNs = timeSharks(scalar, open, rows, cols, steps,
+		[](SharkSchool& s, const bool* o, int r, int c) { s.updateScalar(o, r, c); });
+	double wideNs = timeSharks(wide, open, rows, cols, steps,
+		[](SharkSchool& s, const bool* o, int r, int c) { s.updateAvx2(o, r, c); });
+
+	int mismatches = countMismatches(scalar, wide);
+
+	// The same seed must fill the same numbers, and fill() must draw
+	// what nextInt() does one at a time
+	const int replay = 100000;
+	int* first = new int[replay];
+	int* second = new int[replay];
+	Rng a(20), b(20), c(20);
+	a.fill(first, replay, -3, 1000);
+	b.fill(second, replay, -3, 1000);
+	int replayMismatches = 0;
+	for (int i = 0; i < replay; i++)
+		if (first[i] != second[i] || first[i] != c.nextInt(-3, 1000))
+			replayMismatches++;
+	delete[] first;
+	delete[] second;
+	mismatches += replayMismatches;
+
+	std::cout << "Rng::fill replay: " << replayMismatches << " mismatches" << std::endl;
+	std::cout << sharks << " sharks, " << steps << " steps" << std::endl;
+	std::cout << "scalar: " << scalarNs << " ns/shark step" << std::endl;
+	std::cout << "avx2:   " << wideNs << " ns/shark step"
+		<< (SharkSchool::hasAvx2() ? "" : " (no AVX2, scalar fallback)") << std::endl;
+
+	// Same steps on a pool, every thread count must match the scalar run
+	int maxThreads = ThreadPool::hardwareThreads() < 4 ? 4 : ThreadPool::hardwareThreads();
+	for (int threads = 1; threads <= maxThreads; threads *= 2) {
+		ThreadPool pool(threads);
+		SharkSchool parallel(start);
+		double ns = timeSharks(parallel, open, rows, cols, steps,
+			[&pool](SharkSchool& s, const bool* o, int r, int c) { s.update(o, r, c, &pool); });
+		int wrong = countMismatches(scalar, parallel);
+		mismatches += wrong;
+		std::cout << threads << " thread" << (threads == 1 ? ":  " : "s: ") << ns
+			<< " ns/shark step, " << wrong << " mismatches" << std::endl;
+	}
+	std::cout << "mismatches: " << mismatches << std::endl;
+
+	delete[] open;
+	return mismatches == 0 ? 0 : 1;
+}
+#elif defined(RUN04) //Benchmark the parallel BFS solver
+
+#include"aquarium.h"
+#include"search.h"
+#include"threadpool.h"
+#include"rng.h"
+#include<chrono>
+#include<cstdio>
+#include<fstream>
+#include<iostream>
+
+// Seconds since t1
+double since(std::chrono::steady_clock::time_point t1) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+}
+
+int main() {
+
+	// A big cave: walls round the edge, one cell in five a rock,
+	// start and exit in opposite corners
+	const int rows = 4000, cols = 4000;
+	const char* mazeFile = "bench_bfs_maze.txt";
+	{
+		Rng rng(17);
+		std::ofstream out(mazeFile, std::ios::binary);
+		std::string row(cols, ' ');
+		for (int y = 0; y < rows; y++) {
+			for (int x = 0; x < cols; x++) {
+				bool edge = x == 0 || y == 0 || x == cols - 1 || y == rows - 1;
+				row[x] = edge || rng.nextInt(0, 4) == 0 ? 'X' : ' ';
+			}
+			if (y == 1) row[1] = 'S';
+			if (y == rows - 2) row[cols - 2] = 'E';
+			out << row << '\n';
+		}
+	}
+
+	Aquarium aquarium(mazeFile);
+	remove(mazeFile);
+	Point start = aquarium.getStartPoint();
+	Point end = aquarium.getEndPoint();
+
+	// The game's own breadth first search, one cell per step
+	auto t1 = std::chrono::steady_clock::now();
+	BreadthFirstSearch serial(&aquarium);
+	serial.start(start);
+	bool found = false;
+	while (!serial.empty() && !found) {
+		Point p = serial.target();
+		serial.pop();
+		found = p == end;
+		if (!found)
+			serial.expand(p);
+	}
+	std::cout << rows << " x " << cols << " cells" << std::endl;
+	std::cout << "BreadthFirstSearch:   " << since(t1) << " s, " << (found ? "exit found" : "no exit")
+		<< ", " << serial.nodesExpanded() << " expanded" << std::endl;
+
+	int expected = -2;
+	int mismatches = 0;
+	int maxThreads = ThreadPool::hardwareThreads() < 4 ? 4 : ThreadPool::hardwareThreads();
+	for (int threads = 1; threads <= maxThreads; threads *= 2) {
+		aquarium.setThreads(threads);
+		List<Point> path;
+		t1 = std::chrono::steady_clock::now();
+		int distance = aquarium.solve(&path);
+		double seconds = since(t1);
+
+		if (expected == -2)
+			expected = distance;
+		if (distance != expected || (distance >= 0 && path.size() != distance + 1))
+			mismatches++;
+		std::cout << "ParallelBfs " << threads << " thread" << (threads == 1 ? ":  " : "s: ") << seconds
+			<< " s, distance " << distance << std::endl;
+	}
+	std::cout << "mismatches: " << mismatches << std::endl;
+	return mismatches == 0 ? 0 : 1;
+}
+#elif defined(RUN05) //Compare jump point search with A* and BFS
+
+#include"aquarium.h"
+#include"search.h"
+#include"jumppoint.h"
+#include"mazegen.h"
+#include<chrono>
+#include<iostream>
+#include<string>
+
+// Seconds since t1
+double since(std::chrono::steady_clock::time_point t1) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+}
+
+// Run one of the game's searches from the start until it looks at the
+// exit, print what it cost and return the cells it expanded
+int runSearch(const Aquarium& aquarium, SearchStrategy& search) {
+	Point end = aquarium.getEndPoint();
+	auto t1 = std::chrono::steady_clock::now();
+	search.start(aquarium.getStartPoint());
+	bool found = false;
+	while (!search.empty() && !found) {
+		Point p = search.target();
+		search.pop();
+		found = p == end;
+		if (!found)
+			search.expand(p);
+	}
+	std::cout << "  " << searchKindName(search.kind()) << ":\t" << since(t1) << " s, "
+		<< search.nodesExpanded() << " expanded" << std::endl;
+	return search.nodesExpanded();
+}
+
+// Every solver on one maze, false if jump point search disagrees
+bool compare(const std::string& name, const Aquarium& aquarium) {
+	std::cout << name << ", " << aquarium.rows() << " x " << aquarium.cols() << std::endl;
+	BreadthFirstSearch bfs(&aquarium);
+	AStarSearch astar(&aquarium);
+	runSearch(aquarium, bfs);
+	int astarExpanded = runSearch(aquarium, astar);
+
+	JumpPointSearch jps(aquarium.openBits());
+	PackedPath path;
+	auto t1 = std::chrono::steady_clock::now();
+	int distance = jps.solve(aquarium.getStartPoint(), aquarium.getEndPoint(), &path);
+	double seconds = since(t1);
+	std::cout << "  jps:\t" << seconds << " s, " << jps.nodesExpanded() << " expanded, "
+		<< jps.jumpPoints() << " jump points, " << jps.cellsScanned() << " cells scanned" << std::endl;
+
+	int expected = aquarium.solve((PackedPath*)nullptr);
+	bool same = distance == expected && path.size() == (distance < 0 ? 0 : distance);
+	std::cout << "  distance " << distance << (same ? "" : " MISMATCH, expected " + std::to_string(expected))
+		<< ", A* expanded " << (jps.nodesExpanded() > 0 ? (double)astarExpanded / jps.nodesExpanded() : 0)
+		<< "x as many" << std::endl;
+	return same;
+}
+
+int main() {
+	int mismatches = 0;
+
+	Aquarium open("maze_open.txt");
+	mismatches += !compare("maze_open.txt", open);
+
+	// Open rooms with more and more rocks, then a maze of corridors
+	const double densities[] = { 0.0, 0.05, 0.1, 0.15 };
+	for (double density : densities) {
+		MazeSpec spec(MazeKind::OPEN, 1001, 1001, 11, density);
+		std::string text = MazeGenerator::text(spec);
+		Aquarium aquarium(text.data(), text.size());
+		mismatches += !compare("open, density " + std::to_string(density), aquarium);
+	}
+	MazeSpec spec(MazeKind::BACKTRACKER, 1001, 1001, 11, 0);
+	std::string text = MazeGenerator::text(spec);
+	Aquarium maze(text.data(), text.size());
+	mismatches += !compare("backtracker", maze);
+
+	std::cout << "mismatches: " << mismatches << std::endl;
+	return mismatches == 0 ? 0 : 1;
+}
 #else
 
 
@@ -0,0 +1,195 @@
+#include"mazefile.h"
+#include<cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MAZEFILE_SSE2
+#include<emmintrin.h>
+#endif
+
+#ifdef _MSC_VER  //  Microsoft Visual C++
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(bool) == 1, "scanRow stores open flags as bytes");
+
+MappedFile::MappedFile() :m_data(nullptr), m_size(0)
+#ifdef _MSC_VER
+, m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+const char* MappedFile::data() const {
+	return m_data;
+}
+size_t MappedFile::size() const {
+	return m_size;
+}
+
+#ifdef _MSC_VER
+
+bool MappedFile::open(const std::string& filename) {
+	close();
+	m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size)) {
+		close();
+		return false;
+	}
+	m_size = (size_t)size.QuadPart;
+	// Windows refuses to map an empty file, nothing to map anyway
+	if (m_size == 0)
+		return true;
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping == nullptr) {
+		close();
+		return false;
+	}
+	m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_data == nullptr) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close() {
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+	m_data = nullptr;
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+	m_size = 0;
+}
+
+#else  // not Microsoft Visual C++, so assume POSIX
+
+bool MappedFile::open(const std::string& filename) {
+	close();
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		::close(fd);
+		return false;
+	}
+	m_size = (size_t)st.st_size;
+	// mmap refuses a zero length mapping, nothing to map anyway
+	if (m_size == 0) {
+		::close(fd);
+		return true;
+	}
+
+	void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file
+	::close(fd);
+	if (p == MAP_FAILED) {
+		m_size = 0;
+		return false;
+	}
+	// The loader reads the file front to back exactly once
+	madvise(p, m_size, MADV_SEQUENTIAL);
+	m_data = (const char*)p;
+	return true;
+}
+
+void MappedFile::close() {
+	if (m_data != nullptr)
+		munmap((void*)m_data, m_size);
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#endif
+
+// Index of the lowest set bit, mask must not be zero
+static inline int lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+static inline int popCount(unsigned mask) {
+#ifdef _MSC_VER
+	return (int)__popcnt(mask);
+#else
+	return __builtin_popcount(mask);
+#endif
+}
+
+const char* findNewline(const char* begin, const char* end) {
+	const char* p = begin;
+#ifdef MAZEFILE_SSE2
+	const __m128i newline = _mm_set1_epi8('\n');
+	while (end - p >= 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i*)p);
+		unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+		if (mask != 0)
+			return p + lowestBit(mask);
+		p += 16;
+	}
+#endif
+	while (p < end && *p != '\n')
+		p++;
+	return p;
+}
+
+int scanRow(const char* text, int width, char* cells, bool* open, int& nOpen) {
+	memcpy(cells, text, width);
+
+	int special = width;
+	int i = 0;
+#ifdef MAZEFILE_SSE2
+	const __m128i wall = _mm_set1_epi8('X');
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i one = _mm_set1_epi8(1);
+	for (; i + 16 <= width; i += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(text + i));
+		__m128i isSpace = _mm_cmpeq_epi8(chunk, space);
+		__m128i isWall = _mm_cmpeq_epi8(chunk, wall);
+
+		// Spaces become 1, everything else 0
+		_mm_storeu_si128((__m128i*)(open + i), _mm_and_si128(isSpace, one));
+		nOpen += popCount((unsigned)_mm_movemask_epi8(isSpace));
+
+		unsigned plain = (unsigned)_mm_movemask_epi8(_mm_or_si128(isSpace, isWall));
+		if (plain != 0xFFFF && special == width)
+			special = i + lowestBit(~plain & 0xFFFF);
+	}
+#endif
+	// Tail of the row, or the whole row without SSE2
+	for (; i < width; i++) {
+		char c = text[i];
+		open[i] = (c == ' ');
+		if (c == ' ')
+			nOpen++;
+		else if (c != 'X' && special == width)
+			special = i;
+	}
+	return special;
+}
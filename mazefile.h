@@ -0,0 +1,47 @@
+#ifndef MAZEFILE_H
+#define MAZEFILE_H
+
+#include<string>
+#include<cstddef>
+
+// Read only memory mapping of an entire file.  Lets the Aquarium
+// parse the maze straight out of the page cache in one pass instead
+// of going through iostreams.
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	// Map the whole file, returns false if it could not be opened
+	bool		open(const std::string& filename);
+	void		close();
+
+	const char* data() const;	// nullptr for an empty file
+	size_t		size() const;
+
+private:
+	// Not copyable, owns the mapping
+	MappedFile(const MappedFile& other);
+	MappedFile& operator=(const MappedFile& other);
+
+	const char* m_data;
+	size_t		m_size;
+
+#ifdef _MSC_VER
+	void*		m_file;		// HANDLEs, kept as void* to keep
+	void*		m_mapping;	// windows.h out of this header
+#endif
+};
+
+// Pointer to the first '\n' in [begin, end), or end if there is none.
+// Scans 16 bytes at a time with SSE2 where it is available.
+const char* findNewline(const char* begin, const char* end);
+
+// Copies one row of maze text into cells and sets open[i] for every
+// space.  Returns the column of the first character that is neither
+// 'X' nor ' ', which the caller still has to classify, or width if
+// the row is only walls and spaces.  nOpen is incremented by the
+// number of spaces in the row.
+int scanRow(const char* text, int width, char* cells, bool* open, int& nOpen);
+
+#endif//MAZEFILE_H
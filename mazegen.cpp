@@ -0,0 +1,310 @@
+#include"mazegen.h"
+#include"arraystack.h"
+#include"rng.h"
+#include<cstring>
+#include<fstream>
+
+// Maze cells sit on the odd rows and columns, the walls between them on
+// the even ones.  A maze cell id is j * mazeCols + i for the cell at
+// grid (2i + 1, 2j + 1).
+
+// Cell steps W, E, N, S, the same order the searches use
+static const int DX[4] = { -1, 1, 0, 0 };
+static const int DY[4] = { 0, 0, -1, 1 };
+
+bool parseMazeKind(const std::string& name, MazeKind& kind) {
+	if (name == "backtracker")
+		kind = MazeKind::BACKTRACKER;
+	else if (name == "prim")
+		kind = MazeKind::PRIM;
+	else if (name == "wilson")
+		kind = MazeKind::WILSON;
+	else if (name == "open")
+		kind = MazeKind::OPEN;
+	else
+		return false;
+	return true;
+}
+
+const char* mazeKindName(MazeKind kind) {
+	switch (kind) {
+	case MazeKind::BACKTRACKER:	return "backtracker";
+	case MazeKind::PRIM:		return "prim";
+	case MazeKind::WILSON:		return "wilson";
+	case MazeKind::OPEN:		return "open";
+	}
+	return "?";
+}
+
+MazeSpec::MazeSpec() :kind(MazeKind::BACKTRACKER), rows(21), cols(21), seed(0), density(0.2) {
+}
+
+MazeSpec::MazeSpec(MazeKind kind, int rows, int cols, uint64_t seed, double density)
+	:kind(kind), rows(rows), cols(cols), seed(seed), density(density) {
+}
+
+// Helpers over one maze being carved
+namespace {
+	struct Carver {
+		Carver(const MazeSpec& spec, char* cells)
+			:cells(cells), cols(spec.cols), mazeRows((spec.rows - 1) / 2), mazeCols((spec.cols - 1) / 2) {
+		}
+
+		int		count() const { return mazeRows * mazeCols; }
+
+		// Grid index of maze cell id
+		long long grid(int id) const {
+			return (long long)(2 * (id / mazeCols) + 1) * cols + 2 * (id % mazeCols) + 1;
+		}
+
+		// Neighbour of id in direction d, -1 off the edge
+		int		neighbour(int id, int d) const {
+			int i = id % mazeCols + DX[d];
+			int j = id / mazeCols + DY[d];
+			if ((unsigned)i >= (unsigned)mazeCols || (unsigned)j >= (unsigned)mazeRows)
+				return -1;
+			return j * mazeCols + i;
+		}
+
+		// Open id and the wall between it and its neighbour in direction d
+		void	carve(int id, int d) {
+			long long g = grid(id);
+			cells[g] = ' ';
+			cells[g + DX[d] + (long long)DY[d] * cols] = ' ';
+			cells[g + 2 * DX[d] + 2LL * DY[d] * cols] = ' ';
+		}
+
+		char*	cells;
+		int		cols;
+		int		mazeRows;
+		int		mazeCols;
+	};
+}
+
+bool MazeGenerator::validate(const MazeSpec& spec, std::string& error) {
+	if (spec.rows < 3 || spec.cols < 3) {
+		error = "maze must be at least 3 x 3";
+		return false;
+	}
+	if ((long long)spec.rows * spec.cols > 0x7FFFFFFFLL) {
+		error = "maze has more than 2^31 cells";
+		return false;
+	}
+	if (spec.kind == MazeKind::OPEN) {
+		if ((long long)(spec.rows - 2) * (spec.cols - 2) < 2) {
+			error = "maze too small for a start and an exit";
+			return false;
+		}
+		if (!(spec.density >= 0 && spec.density < 1)) {
+			error = "density must be at least 0 and below 1";
+			return false;
+		}
+	}
+	else if ((long long)((spec.rows - 1) / 2) * ((spec.cols - 1) / 2) < 2) {
+		error = "maze too small for a start and an exit";
+		return false;
+	}
+	return true;
+}
+
+void MazeGenerator::generate(const MazeSpec& spec, char* cells) {
+	switch (spec.kind) {
+	case MazeKind::BACKTRACKER:	backtracker(spec, cells); break;
+	case MazeKind::PRIM:		prim(spec, cells); break;
+	case MazeKind::WILSON:		wilson(spec, cells); break;
+	case MazeKind::OPEN:		open(spec, cells); return;
+	}
+
+	// Start in the first maze cell, exit in the last
+	Carver maze(spec, cells);
+	cells[maze.grid(0)] = 'S';
+	cells[maze.grid(maze.count() - 1)] = 'E';
+}
+
+//  backtracker()
+//		Walk from the first cell to a random unvisited neighbour,
+//		carving as it goes, and back up the stack at dead ends.
+void MazeGenerator::backtracker(const MazeSpec& spec, char* cells) {
+	memset(cells, 'X', (size_t)spec.rows * spec.cols);
+	Carver maze(spec, cells);
+	Rng rng(spec.seed);
+
+	char* visited = new char[maze.count()]();
+	ArrayStack<int> path;
+	path.push(0);
+	visited[0] = 1;
+	cells[maze.grid(0)] = ' ';
+
+	while (!path.empty()) {
+		int id = path.top();
+		int choices[4];
+		int nChoices = 0;
+		for (int d = 0; d < 4; d++) {
+			int next = maze.neighbour(id, d);
+			if (next >= 0 && !visited[next])
+				choices[nChoices++] = d;
+		}
+		if (nChoices == 0) {
+			path.pop();
+			continue;
+		}
+		int d = choices[rng.nextInt(0, nChoices - 1)];
+		int next = maze.neighbour(id, d);
+		maze.carve(id, d);
+		visited[next] = 1;
+		path.push(next);
+	}
+	delete[] visited;
+}
+
+//  prim()
+//		Grow the maze from the first cell.  Every cell next to the
+//		maze waits in a frontier, a random one is taken each step and
+//		joined through a random wall to a cell already in the maze.
+void MazeGenerator::prim(const MazeSpec& spec, char* cells) {
+	memset(cells, 'X', (size_t)spec.rows * spec.cols);
+	Carver maze(spec, cells);
+	Rng rng(spec.seed);
+
+	enum { OUTSIDE, FRONTIER, INSIDE };
+	char* state = new char[maze.count()]();
+	ArrayStack<int> frontier;
+
+	auto add = [&](int id) {
+		state[id] = INSIDE;
+		cells[maze.grid(id)] = ' ';
+		for (int d = 0; d < 4; d++) {
+			int next = maze.neighbour(id, d);
+			if (next >= 0 && state[next] == OUTSIDE) {
+				state[next] = FRONTIER;
+				frontier.push(next);
+			}
+		}
+	};
+	add(0);
+
+	while (!frontier.empty()) {
+		// Swap a random entry to the top and take it
+		int pick = rng.nextInt(0, frontier.size() - 1);
+		int id = frontier[pick];
+		frontier[pick] = frontier.top();
+		frontier.pop();
+
+		int choices[4];
+		int nChoices = 0;
+		for (int d = 0; d < 4; d++) {
+			int next = maze.neighbour(id, d);
+			if (next >= 0 && state[next] == INSIDE)
+				choices[nChoices++] = d;
+		}
+		maze.carve(id, choices[rng.nextInt(0, nChoices - 1)]);
+		add(id);
+	}
+	delete[] state;
+}
+
+//  wilson()
+//		Random walk from each cell not yet in the maze until the walk
+//		hits the maze, remembering only the last way out of every
+//		cell, which erases the loops.  Then carve the walk's path.
+void MazeGenerator::wilson(const MazeSpec& spec, char* cells) {
+	memset(cells, 'X', (size_t)spec.rows * spec.cols);
+	Carver maze(spec, cells);
+	Rng rng(spec.seed);
+
+	int count = maze.count();
+	char* inMaze = new char[count]();
+	unsigned char* way = new unsigned char[count];
+
+	// Seed the maze with a random cell
+	int root = rng.nextInt(0, count - 1);
+	inMaze[root] = 1;
+	cells[maze.grid(root)] = ' ';
+
+	for (int first = 0; first < count; first++) {
+		if (inMaze[first])
+			continue;
+
+		int id = first;
+		while (!inMaze[id]) {
+			int d, next;
+			do {
+				d = rng.nextInt(0, 3);
+				next = maze.neighbour(id, d);
+			} while (next < 0);
+			way[id] = (unsigned char)d;
+			id = next;
+		}
+
+		for (id = first; !inMaze[id]; id = maze.neighbour(id, way[id])) {
+			inMaze[id] = 1;
+			maze.carve(id, way[id]);
+		}
+	}
+	delete[] way;
+	delete[] inMaze;
+}
+
+//  open()
+//		Walls round the edge, rocks scattered at density, the start
+//		and exit in opposite corners kept clear.
+void MazeGenerator::open(const MazeSpec& spec, char* cells) {
+	Rng rng(spec.seed);
+	// Compare against a 32 bit threshold instead of a double per cell
+	uint32_t threshold = (uint32_t)(spec.density * 4294967296.0);
+	for (int y = 0; y < spec.rows; y++) {
+		char* row = cells + (size_t)y * spec.cols;
+		for (int x = 0; x < spec.cols; x++) {
+			bool edge = x == 0 || y == 0 || x == spec.cols - 1 || y == spec.rows - 1;
+			row[x] = edge || rng.nextU32() < threshold ? 'X' : ' ';
+		}
+	}
+
+	// Bottom right cell inside the walls, the start's neighbour when
+	// the field is a single row or column
+	int ex = spec.cols - 2, ey = spec.rows - 2;
+	if (ex == 1 && ey == 1)
+		ex = 2;
+	cells[(size_t)spec.cols + 1] = 'S';
+	cells[(size_t)ey * spec.cols + ex] = 'E';
+}
+
+std::string MazeGenerator::text(const MazeSpec& spec) {
+	size_t cellCount = (size_t)spec.rows * spec.cols;
+	char* cells = new char[cellCount];
+	generate(spec, cells);
+
+	std::string out;
+	out.reserve(cellCount + spec.rows);
+	for (int y = 0; y < spec.rows; y++) {
+		out.append(cells + (size_t)y * spec.cols, spec.cols);
+		out += '\n';
+	}
+	delete[] cells;
+	return out;
+}
+
+bool MazeGenerator::write(const MazeSpec& spec, const std::string& filename) {
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	size_t cellCount = (size_t)spec.rows * spec.cols;
+	char* cells = new char[cellCount];
+	generate(spec, cells);
+
+	// Newlines put in by rows, written out in blocks of about 1MB
+	const size_t block = 1 << 20;
+	std::string out;
+	out.reserve(block + spec.cols + 1);
+	for (int y = 0; y < spec.rows; y++) {
+		out.append(cells + (size_t)y * spec.cols, spec.cols);
+		out += '\n';
+		if (out.size() >= block || y == spec.rows - 1) {
+			file.write(out.data(), out.size());
+			out.clear();
+		}
+	}
+	delete[] cells;
+	return (bool)file;
+}
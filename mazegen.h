@@ -0,0 +1,57 @@
+#ifndef MAZEGEN_H
+#define MAZEGEN_H
+
+#include<string>
+#include<cstdint>
+
+// How a maze is carved.
+//		BACKTRACKER: depth first random walk, long twisty corridors
+//		PRIM:		 randomized Prim's, short dead ends branching everywhere
+//		WILSON:		 loop erased random walks, every perfect maze equally likely
+//		OPEN:		 open field, each cell a rock with probability density
+// The first three are perfect mazes, exactly one route between any two
+// cells, carved on the odd rows and columns.
+enum class MazeKind { BACKTRACKER, PRIM, WILSON, OPEN };
+
+// "backtracker", "prim", "wilson", "open" <-> MazeKind.
+// parseMazeKind returns false for an unknown name.
+bool		parseMazeKind(const std::string& name, MazeKind& kind);
+const char* mazeKindName(MazeKind kind);
+
+// What to generate.  The same spec always gives the same maze.
+struct MazeSpec {
+	MazeSpec();
+	MazeSpec(MazeKind kind, int rows, int cols, uint64_t seed, double density = 0.2);
+
+	MazeKind	kind;
+	int			rows;
+	int			cols;
+	uint64_t	seed;
+	double		density;	// Rock fraction for OPEN, unused by the others
+};
+
+// Generates mazes in the aquarium's text format: 'X' walls, ' ' open,
+// one 'S' top left and one 'E' bottom right, surrounded by walls.
+class MazeGenerator {
+public:
+	// False with error set if the spec is too small to hold a start
+	// and an exit, or has a density outside [0, 1)
+	static bool	validate(const MazeSpec& spec, std::string& error);
+
+	// Fill cells, spec.rows * spec.cols chars row-major without newlines
+	static void	generate(const MazeSpec& spec, char* cells);
+
+	// The maze as text, rows ending in '\n', ready for Aquarium
+	static std::string text(const MazeSpec& spec);
+
+	// Write the maze to filename, false if it cannot be written
+	static bool	write(const MazeSpec& spec, const std::string& filename);
+
+private:
+	static void	backtracker(const MazeSpec& spec, char* cells);
+	static void	prim(const MazeSpec& spec, char* cells);
+	static void	wilson(const MazeSpec& spec, char* cells);
+	static void	open(const MazeSpec& spec, char* cells);
+};
+
+#endif//MAZEGEN_H
@@ -0,0 +1,250 @@
+#include"metrics.h"
+#include<chrono>
+#include<fstream>
+#include<cstring>
+
+#ifdef _MSC_VER  //  Microsoft Visual C++
+#include <intrin.h>
+#endif
+
+const char* phaseName(Phase phase) {
+	switch (phase) {
+	case Phase::LOAD:			return "load";
+	case Phase::PLAYER_UPDATE:	return "playerUpdate";
+	case Phase::SHARK_UPDATE:	return "sharkUpdate";
+	case Phase::INTERACT:		return "interact";
+	case Phase::DRAW:			return "draw";
+	case Phase::STEP:			return "step";
+	default:					return "unknown";
+	}
+}
+
+const char* counterName(Counter counter) {
+	switch (counter) {
+	case Counter::STEPS:				return "steps";
+	case Counter::CELLS_DISCOVERED:		return "cellsDiscovered";
+	case Counter::NODES_EXPANDED:		return "nodesExpanded";
+	case Counter::FRONTIER_HIGH_WATER:	return "frontierHighWater";
+	case Counter::BACKTRACK_HIGH_WATER:	return "backtrackHighWater";
+	case Counter::ALLOCATIONS:			return "allocations";
+	default:							return "unknown";
+	}
+}
+
+int64_t metricsNow() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Index of the highest set bit, value must not be zero.  Two 32 bit
+// scans so it also builds for 32 bit targets.
+static inline int highestBit(uint64_t value) {
+#ifdef _MSC_VER
+	unsigned long index;
+	if (_BitScanReverse(&index, (unsigned long)(value >> 32)))
+		return (int)index + 32;
+	_BitScanReverse(&index, (unsigned long)value);
+	return (int)index;
+#else
+	return 63 - __builtin_clzll(value);
+#endif
+}
+
+
+// LatencyHistogram
+//
+
+LatencyHistogram::LatencyHistogram() {
+	reset();
+}
+
+void LatencyHistogram::reset() {
+	memset(m_buckets, 0, sizeof(m_buckets));
+	m_count = 0;
+	m_total = 0;
+	m_min = 0;
+	m_max = 0;
+}
+
+//  bucketOf( ... )
+//		Below SUB_BUCKETS a value is its own bucket.  Above, the top
+//		SUB_BITS + 1 bits pick the bucket: the position of the highest
+//		bit the power of two, the SUB_BITS after it the slice of it.
+int LatencyHistogram::bucketOf(uint64_t ns) {
+	if (ns < (uint64_t)SUB_BUCKETS)
+		return (int)ns;
+	int high = highestBit(ns);
+	int sub = (int)(ns >> (high - SUB_BITS)) & (SUB_BUCKETS - 1);
+	return (high - SUB_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketTop(int bucket) {
+	if (bucket < SUB_BUCKETS)
+		return (uint64_t)bucket;
+	int high = bucket / SUB_BUCKETS + SUB_BITS - 1;
+	int sub = bucket % SUB_BUCKETS;
+	uint64_t width = (uint64_t)1 << (high - SUB_BITS);
+	return ((uint64_t)(SUB_BUCKETS + sub) << (high - SUB_BITS)) + width - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+	m_buckets[bucketOf(ns)]++;
+	if (m_count == 0 || ns < m_min)
+		m_min = ns;
+	if (ns > m_max)
+		m_max = ns;
+	m_count++;
+	m_total += ns;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+	if (other.m_count == 0)
+		return;
+	for (int i = 0; i < BUCKETS; i++)
+		m_buckets[i] += other.m_buckets[i];
+	if (m_count == 0 || other.m_min < m_min)
+		m_min = other.m_min;
+	if (other.m_max > m_max)
+		m_max = other.m_max;
+	m_count += other.m_count;
+	m_total += other.m_total;
+}
+
+uint64_t LatencyHistogram::count() const {
+	return m_count;
+}
+uint64_t LatencyHistogram::total() const {
+	return m_total;
+}
+uint64_t LatencyHistogram::min() const {
+	return m_min;
+}
+uint64_t LatencyHistogram::max() const {
+	return m_max;
+}
+double LatencyHistogram::mean() const {
+	return m_count == 0 ? 0 : (double)m_total / m_count;
+}
+
+//  percentile( ... )
+//		Walk the buckets until q of the samples are covered.  The
+//		answer is the top of that bucket, clamped to the largest sample
+//		so p100 is exact.
+uint64_t LatencyHistogram::percentile(double q) const {
+	if (m_count == 0)
+		return 0;
+	if (q <= 0)
+		return m_min;
+	uint64_t rank = (uint64_t)(q * m_count + 0.5);
+	if (rank < 1)
+		rank = 1;
+	if (rank > m_count)
+		rank = m_count;
+
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKETS; i++) {
+		seen += m_buckets[i];
+		if (seen >= rank) {
+			uint64_t top = bucketTop(i);
+			if (top < m_min)
+				return m_min;
+			return top < m_max ? top : m_max;
+		}
+	}
+	return m_max;
+}
+
+
+// Metrics
+//
+
+Metrics::Metrics() {
+	reset();
+}
+
+void Metrics::reset() {
+	for (int i = 0; i < (int)Phase::COUNT; i++)
+		m_phases[i].reset();
+	for (int i = 0; i < (int)Counter::COUNT; i++)
+		m_counters[i] = 0;
+}
+
+void Metrics::record(Phase phase, uint64_t ns) {
+	m_phases[(int)phase].record(ns);
+}
+
+const LatencyHistogram& Metrics::phase(Phase phase) const {
+	return m_phases[(int)phase];
+}
+
+void Metrics::set(Counter counter, int64_t value) {
+	m_counters[(int)counter] = value;
+}
+
+int64_t Metrics::get(Counter counter) const {
+	return m_counters[(int)counter];
+}
+
+void Metrics::writeJson(std::ostream& os) const {
+	os << "{\n  \"phases\": {";
+	for (int i = 0; i < (int)Phase::COUNT; i++) {
+		const LatencyHistogram& h = m_phases[i];
+		os << (i == 0 ? "\n" : ",\n") << "    \"" << phaseName((Phase)i) << "\": {"
+			<< "\"count\": " << h.count()
+			<< ", \"totalNs\": " << h.total()
+			<< ", \"meanNs\": " << h.mean()
+			<< ", \"minNs\": " << h.min()
+			<< ", \"p50Ns\": " << h.percentile(0.5)
+			<< ", \"p99Ns\": " << h.percentile(0.99)
+			<< ", \"maxNs\": " << h.max() << "}";
+	}
+	os << "\n  },\n  \"counters\": {";
+	for (int i = 0; i < (int)Counter::COUNT; i++) {
+		os << (i == 0 ? "\n" : ",\n") << "    \"" << counterName((Counter)i) << "\": "
+			<< m_counters[i];
+	}
+	os << "\n  }\n}\n";
+}
+
+void Metrics::writeCsv(std::ostream& os) const {
+	os << "metric,count,total_ns,mean_ns,min_ns,p50_ns,p99_ns,max_ns\n";
+	for (int i = 0; i < (int)Phase::COUNT; i++) {
+		const LatencyHistogram& h = m_phases[i];
+		os << phaseName((Phase)i) << ',' << h.count() << ',' << h.total() << ',' << h.mean()
+			<< ',' << h.min() << ',' << h.percentile(0.5) << ',' << h.percentile(0.99)
+			<< ',' << h.max() << '\n';
+	}
+	for (int i = 0; i < (int)Counter::COUNT; i++)
+		os << counterName((Counter)i) << ',' << m_counters[i] << ",,,,,,\n";
+}
+
+bool Metrics::write(const std::string& filename, std::string& error) const {
+	std::ofstream file(filename);
+	if (!file.is_open()) {
+		error = "could not open metrics file " + filename;
+		return false;
+	}
+	const std::string csv = ".csv";
+	if (filename.size() >= csv.size() &&
+		filename.compare(filename.size() - csv.size(), csv.size(), csv) == 0)
+		writeCsv(file);
+	else
+		writeJson(file);
+	if (!file) {
+		error = "could not write metrics file " + filename;
+		return false;
+	}
+	return true;
+}
+
+
+// PhaseTimer
+//
+
+PhaseTimer::PhaseTimer(Metrics& metrics, Phase phase)
+	:m_metrics(metrics), m_phase(phase), m_start(metricsNow()) {
+}
+
+PhaseTimer::~PhaseTimer() {
+	m_metrics.record(m_phase, (uint64_t)(metricsNow() - m_start));
+}
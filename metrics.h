@@ -0,0 +1,118 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include<cstdint>
+#include<string>
+#include<iostream>
+
+// The phases of a game timed every time they run.  STEP is a whole
+// headless game loop iteration, update and interact together; an
+// interactive step would mostly time the user.
+enum class Phase { LOAD, PLAYER_UPDATE, SHARK_UPDATE, INTERACT, DRAW, STEP, COUNT };
+
+// What else a run is measured by, set from the player at the end
+enum class Counter {
+	STEPS,					// Game loop iterations
+	CELLS_DISCOVERED,		// Cells the player's search has seen
+	NODES_EXPANDED,			// Cells the player's search looked around
+	FRONTIER_HIGH_WATER,	// Most cells waiting in the search at once
+	BACKTRACK_HIGH_WATER,	// Deepest the player's backtrack stack got
+	ALLOCATIONS,			// Blocks the player's containers allocated
+	COUNT
+};
+
+// "load", "playerUpdate", ... and "steps", "cellsDiscovered", ...
+const char* phaseName(Phase phase);
+const char* counterName(Counter counter);
+
+// Log bucketed histogram of nanosecond latencies.
+//
+// Every power of two is split into SUB_BUCKETS equal buckets, so a
+// percentile is off by at most 1/SUB_BUCKETS (12.5%) of the value and
+// recording is a bit scan and an increment, no allocation.  The exact
+// min, max and total are kept alongside.
+class LatencyHistogram {
+public:
+	LatencyHistogram();
+
+	void		record(uint64_t ns);
+	void		reset();
+	// Add other's samples to these
+	void		merge(const LatencyHistogram& other);
+
+	uint64_t	count() const;
+	uint64_t	total() const;	// Sum of every sample
+	uint64_t	min() const;	// 0 when empty
+	uint64_t	max() const;
+	double		mean() const;
+
+	// Smallest bucket bound at or above q (0 to 1) of the samples,
+	// never more than max().  0 when empty.
+	uint64_t	percentile(double q) const;
+
+private:
+	static const int SUB_BITS = 3;
+	static const int SUB_BUCKETS = 1 << SUB_BITS;
+	// Values below SUB_BUCKETS get a bucket each, then SUB_BUCKETS
+	// per power of two up to 2^63
+	static const int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+	static int		bucketOf(uint64_t ns);
+	static uint64_t	bucketTop(int bucket);	// Largest value in the bucket
+
+	uint64_t	m_buckets[BUCKETS];
+	uint64_t	m_count;
+	uint64_t	m_total;
+	uint64_t	m_min;
+	uint64_t	m_max;
+};
+
+// Per phase latency histograms and run counters of one game.
+// Not thread safe, the game loop owns it.
+class Metrics {
+public:
+	Metrics();
+
+	void		record(Phase phase, uint64_t ns);
+	const LatencyHistogram& phase(Phase phase) const;
+
+	void		set(Counter counter, int64_t value);
+	int64_t		get(Counter counter) const;
+
+	void		reset();
+
+	// One object with a "phases" object of {count, totalNs, meanNs,
+	// minNs, p50Ns, p99Ns, maxNs} per phase and a "counters" object
+	void		writeJson(std::ostream& os) const;
+	// metric,count,total_ns,mean_ns,min_ns,p50_ns,p99_ns,max_ns rows,
+	// counters have only their value in the count column
+	void		writeCsv(std::ostream& os) const;
+	// CSV if filename ends in ".csv", JSON otherwise.  False with
+	// error set if the file cannot be written.
+	bool		write(const std::string& filename, std::string& error) const;
+
+private:
+	LatencyHistogram m_phases[(int)Phase::COUNT];
+	int64_t		m_counters[(int)Counter::COUNT];
+};
+
+// Times its own lifetime into one phase of metrics
+class PhaseTimer {
+public:
+	PhaseTimer(Metrics& metrics, Phase phase);
+	~PhaseTimer();
+
+private:
+	// Not copyable
+	PhaseTimer(const PhaseTimer& other);
+	PhaseTimer& operator=(const PhaseTimer& other);
+
+	Metrics&	m_metrics;
+	Phase		m_phase;
+	int64_t		m_start;
+};
+
+// Monotonic clock in nanoseconds, for timing phases by hand
+int64_t metricsNow();
+
+#endif//METRICS_H
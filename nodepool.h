@@ -0,0 +1,206 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include<cstddef>
+#include<new>
+#include<utility>
+
+// Allocator policies for the Nodes of a List.
+//
+// A policy is a class template over the node type that hands out raw,
+// uninitialized storage for one node at a time.  The List constructs
+// and destroys the nodes itself.  Every policy provides:
+//
+//		Node*	allocate();				storage for one node
+//		void	deallocate(Node* n);	give it back (n already destroyed)
+//		void	release();				free everything at once
+//		bool	releasesAll() const;	does release() free live nodes' memory
+//		void	swap(Policy& other);
+//
+// plus counters so the node churn can be checked from outside:
+//
+//		allocations()		nodes handed out over the policy's lifetime
+//		heapAllocations()	calls made to the global operator new
+//		live()				nodes handed out and not yet given back
+
+
+// NodePool
+//		Free list / slab pool.  Nodes are carved out of slabs that double
+//		in size up to MAX_SLAB nodes, freed nodes go on a free list and are
+//		handed out again first.  In steady state allocate() and deallocate()
+//		are a couple of pointer moves, and release() frees whole slabs.
+template<typename Node>
+class NodePool {
+public:
+	NodePool();
+	~NodePool();
+
+	Node*	allocate();
+	void	deallocate(Node* n);
+	void	release();
+	bool	releasesAll() const { return true; }
+	void	swap(NodePool& other);
+
+	int		allocations() const { return m_allocations; }
+	int		heapAllocations() const { return m_heapAllocations; }
+	int		live() const { return m_live; }
+
+private:
+	// Not copyable, each List owns its own pool
+	NodePool(const NodePool& other);
+	NodePool& operator=(const NodePool& other);
+
+	static const int MIN_SLAB = 16;
+	static const int MAX_SLAB = 4096;
+
+	// Freed nodes are reused as links of the free list
+	struct FreeSlot { FreeSlot* next; };
+	// Every slab starts with a link to the previously allocated slab
+	struct SlabHeader { SlabHeader* next; };
+
+	static size_t slotSize();
+	static size_t headerSize();
+
+	void	grow();
+
+	FreeSlot*	m_free;		// Recycled nodes
+	SlabHeader*	m_slabs;	// All slabs, newest first
+	char*		m_cursor;	// Next never used node in the newest slab
+	char*		m_limit;	// End of the newest slab
+	int			m_slabNodes;	// Size of the next slab in nodes
+
+	int			m_allocations;
+	int			m_heapAllocations;
+	int			m_live;
+};
+
+// HeapAllocator
+//		One global new/delete per node, what List did before pooling.
+//		Kept for comparison and for Types that need it.
+template<typename Node>
+class HeapAllocator {
+public:
+	HeapAllocator() :m_allocations(0), m_live(0) {}
+
+	Node* allocate() {
+		m_allocations++;
+		m_live++;
+		return static_cast<Node*>(::operator new(sizeof(Node)));
+	}
+	void	deallocate(Node* n) {
+		m_live--;
+		::operator delete(n);
+	}
+	void	release() {}
+	bool	releasesAll() const { return false; }
+	void	swap(HeapAllocator& other) {
+		std::swap(m_allocations, other.m_allocations);
+		std::swap(m_live, other.m_live);
+	}
+
+	int		allocations() const { return m_allocations; }
+	int		heapAllocations() const { return m_allocations; }
+	int		live() const { return m_live; }
+
+private:
+	int		m_allocations;
+	int		m_live;
+};
+
+
+// NodePool Implementation
+//
+
+template<typename Node>
+NodePool<Node>::NodePool() :m_free(nullptr), m_slabs(nullptr), m_cursor(nullptr), m_limit(nullptr),
+	m_slabNodes(MIN_SLAB), m_allocations(0), m_heapAllocations(0), m_live(0) {
+}
+
+template<typename Node>
+NodePool<Node>::~NodePool() {
+	release();
+}
+
+// A slot must hold either a Node or a free list link, and keep the
+// next slot aligned for Node
+template<typename Node>
+size_t NodePool<Node>::slotSize() {
+	size_t size = sizeof(Node) > sizeof(FreeSlot) ? sizeof(Node) : sizeof(FreeSlot);
+	size_t align = alignof(Node) > alignof(FreeSlot) ? alignof(Node) : alignof(FreeSlot);
+	return (size + align - 1) / align * align;
+}
+
+// The header is padded so the first node is suitably aligned
+template<typename Node>
+size_t NodePool<Node>::headerSize() {
+	size_t align = alignof(std::max_align_t);
+	return (sizeof(SlabHeader) + align - 1) / align * align;
+}
+
+template<typename Node>
+void NodePool<Node>::grow() {
+	size_t bytes = headerSize() + slotSize() * m_slabNodes;
+	SlabHeader* slab = static_cast<SlabHeader*>(::operator new(bytes));
+	m_heapAllocations++;
+
+	slab->next = m_slabs;
+	m_slabs = slab;
+	m_cursor = reinterpret_cast<char*>(slab) + headerSize();
+	m_limit = reinterpret_cast<char*>(slab) + bytes;
+
+	if (m_slabNodes < MAX_SLAB)
+		m_slabNodes *= 2;
+}
+
+template<typename Node>
+Node* NodePool<Node>::allocate() {
+	m_allocations++;
+	m_live++;
+	if (m_free != nullptr) {
+		FreeSlot* slot = m_free;
+		m_free = slot->next;
+		return reinterpret_cast<Node*>(slot);
+	}
+	if (m_cursor == m_limit)
+		grow();
+	Node* n = reinterpret_cast<Node*>(m_cursor);
+	m_cursor += slotSize();
+	return n;
+}
+
+template<typename Node>
+void NodePool<Node>::deallocate(Node* n) {
+	m_live--;
+	FreeSlot* slot = reinterpret_cast<FreeSlot*>(n);
+	slot->next = m_free;
+	m_free = slot;
+}
+
+// Free every slab.  Any node still handed out is gone after this,
+// the List must have destroyed them first if their Type needs it.
+template<typename Node>
+void NodePool<Node>::release() {
+	while (m_slabs != nullptr) {
+		SlabHeader* next = m_slabs->next;
+		::operator delete(m_slabs);
+		m_slabs = next;
+	}
+	m_free = nullptr;
+	m_cursor = m_limit = nullptr;
+	m_slabNodes = MIN_SLAB;
+	m_live = 0;
+}
+
+template<typename Node>
+void NodePool<Node>::swap(NodePool& other) {
+	std::swap(m_free, other.m_free);
+	std::swap(m_slabs, other.m_slabs);
+	std::swap(m_cursor, other.m_cursor);
+	std::swap(m_limit, other.m_limit);
+	std::swap(m_slabNodes, other.m_slabNodes);
+	std::swap(m_allocations, other.m_allocations);
+	std::swap(m_heapAllocations, other.m_heapAllocations);
+	std::swap(m_live, other.m_live);
+}
+
+#endif//NODEPOOL_H
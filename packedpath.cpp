@@ -0,0 +1,158 @@
+#include"packedpath.h"
+#include<fstream>
+#include<sstream>
+
+static const int DX[4] = { -1, 1, 0, 0 };
+static const int DY[4] = { 0, 0, -1, 1 };
+static const char LETTERS[4] = { 'W', 'E', 'N', 'S' };
+
+// Steps per line of a saved path
+static const int PATH_LINE = 64;
+
+PackedPath::PackedPath() :m_start(0, 0), m_size(0), m_bytes() {
+}
+
+PackedPath::PackedPath(Point start) :m_start(start), m_size(0), m_bytes() {
+}
+
+void PackedPath::clear(Point start) {
+	m_start = start;
+	m_size = 0;
+	m_bytes.clear();
+}
+
+void PackedPath::push(int dir) {
+	if (m_size % 4 == 0)
+		m_bytes.push(0);
+	m_bytes[m_size / 4] |= (unsigned char)((dir & 3) << (2 * (m_size % 4)));
+	m_size++;
+}
+
+void PackedPath::resize(int steps) {
+	int bytes = (steps + 3) / 4;
+	m_bytes.reserve(bytes);
+	while (m_bytes.size() > bytes)
+		m_bytes.pop();
+	while (m_bytes.size() < bytes)
+		m_bytes.push(0);
+	// Clear the codes past the end of the last byte
+	if (steps % 4 != 0)
+		m_bytes[bytes - 1] &= (unsigned char)((1 << (2 * (steps % 4))) - 1);
+	m_size = steps;
+}
+
+void PackedPath::set(int i, int dir) {
+	unsigned char& byte = m_bytes[i / 4];
+	int shift = 2 * (i % 4);
+	byte = (unsigned char)((byte & ~(3 << shift)) | ((dir & 3) << shift));
+}
+
+int PackedPath::dir(int i) const {
+	return (m_bytes[i / 4] >> (2 * (i % 4))) & 3;
+}
+
+int PackedPath::size() const {
+	return m_size;
+}
+
+Point PackedPath::start() const {
+	return m_start;
+}
+
+Point PackedPath::end() const {
+	Point p = m_start;
+	for (int i = 0; i < m_size; i++)
+		p = step(p, dir(i));
+	return p;
+}
+
+void PackedPath::toPoints(List<Point>& points) const {
+	points = List<Point>();
+	Point p = m_start;
+	points.push_back(p);
+	for (int i = 0; i < m_size; i++) {
+		p = step(p, dir(i));
+		points.push_back(p);
+	}
+}
+
+size_t PackedPath::bytes() const {
+	return (size_t)m_bytes.size();
+}
+
+Point PackedPath::step(Point p, int dir) {
+	return Point(p.getX() + DX[dir], p.getY() + DY[dir]);
+}
+
+char PackedPath::letter(int dir) {
+	return LETTERS[dir & 3];
+}
+
+bool PackedPath::write(const std::string& filename, std::string& error) const {
+	std::ofstream file(filename);
+	if (!file.is_open()) {
+		error = "could not open path file " + filename;
+		return false;
+	}
+	file << "path " << m_start.getX() << ' ' << m_start.getY() << ' ' << m_size << '\n';
+
+	// A line at a time instead of a character at a time
+	char line[PATH_LINE + 1];
+	for (int i = 0; i < m_size; i += PATH_LINE) {
+		int n = m_size - i < PATH_LINE ? m_size - i : PATH_LINE;
+		for (int j = 0; j < n; j++)
+			line[j] = LETTERS[dir(i + j)];
+		line[n] = '\n';
+		file.write(line, n + 1);
+	}
+	if (!file) {
+		error = "could not write path file " + filename;
+		return false;
+	}
+	return true;
+}
+
+bool PackedPath::read(const std::string& filename, std::string& error) {
+	clear(Point(0, 0));
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		error = "could not open path file " + filename;
+		return false;
+	}
+
+	std::string header;
+	std::getline(file, header);
+	std::istringstream fields(header);
+	std::string word;
+	int x = 0, y = 0, steps = -1;
+	if (!(fields >> word >> x >> y >> steps) || word != "path" || steps < 0) {
+		error = filename + ": expected \"path <x> <y> <steps>\" on the first line";
+		return false;
+	}
+
+	m_start.set(x, y);
+	m_bytes.reserve((steps + 3) / 4);
+	std::string line;
+	while (std::getline(file, line)) {
+		for (char c : line) {
+			int dir = 0;
+			while (dir < 4 && LETTERS[dir] != c)
+				dir++;
+			if (dir == 4) {
+				if (c == '\r')
+					continue;
+				error = filename + ": unexpected character '" + c + "', expected one of W, E, N, S";
+				clear(Point(0, 0));
+				return false;
+			}
+			push(dir);
+		}
+	}
+	if (m_size != steps) {
+		error = filename + ": header says " + std::to_string(steps) + " steps, found "
+			+ std::to_string(m_size);
+		clear(Point(0, 0));
+		return false;
+	}
+	return true;
+}
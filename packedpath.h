@@ -0,0 +1,65 @@
+#ifndef PACKEDPATH_H
+#define PACKEDPATH_H
+
+#include<string>
+#include<cstddef>
+#include"point.h"
+#include"list.h"
+#include"arraystack.h"
+
+// Direction codes of a PackedPath step, the W, E, N, S order of the
+// searches.  d ^ 1 is the opposite of d.
+const int PATH_W = 0;
+const int PATH_E = 1;
+const int PATH_N = 2;
+const int PATH_S = 3;
+
+// A route through the aquarium as its first cell and one 2 bit
+// direction code per step, four steps to a byte.  A million step route
+// is 250 KB where the same List<Point> is tens of MB of nodes.
+//
+// Saved as text, a header line then the steps as the letters W, E, N
+// and S, 64 to a line:
+//
+//		path <start x> <start y> <steps>
+//		EEEESSSSWW...
+class PackedPath {
+public:
+	PackedPath();
+	explicit PackedPath(Point start);
+
+	// Forget every step and begin again at start
+	void	clear(Point start);
+
+	// Append one step in direction dir
+	void	push(int dir);
+	// Make it steps long, new steps are W until set()
+	void	resize(int steps);
+	void	set(int i, int dir);
+
+	int		dir(int i) const;		// Direction of step i
+	int		size() const;			// Steps, one less than the cells
+	Point	start() const;
+	Point	end() const;			// Walks every step, O(size())
+
+	// Every cell of the route, start and end included
+	void	toPoints(List<Point>& points) const;
+
+	size_t	bytes() const;			// Storage of the steps
+
+	// False with error set if the file cannot be written or read.
+	// A failed read leaves the path empty at (0, 0).
+	bool	write(const std::string& filename, std::string& error) const;
+	bool	read(const std::string& filename, std::string& error);
+
+	// Cell one step from p in direction dir
+	static Point step(Point p, int dir);
+	static char	letter(int dir);	// 'W', 'E', 'N', 'S'
+
+private:
+	Point	m_start;
+	int		m_size;
+	ArrayStack<unsigned char> m_bytes;	// Step i in bits 2 * (i % 4) of byte i / 4
+};
+
+#endif//PACKEDPATH_H
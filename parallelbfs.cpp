@@ -0,0 +1,184 @@
+#include"parallelbfs.h"
+#include"threadpool.h"
+#include<cstring>
+
+// Frontier cells per parallel chunk
+static const int BFS_GRAIN = 2048;
+// Cells a thread gathers before reserving room in the next frontier
+static const int BFS_LOCAL = 256;
+
+// Neighbour offsets W, E, N, S, same order as the game's searches
+static const int DX[4] = { -1, 1, 0, 0 };
+static const int DY[4] = { 0, 0, -1, 1 };
+
+ParallelBfs::ParallelBfs(const bool* open, int rows, int cols)
+	:m_open(open), m_rows(rows), m_cols(cols), m_visited(nullptr), m_words(0),
+	m_frontier(nullptr), m_frontierSize(0), m_next(nullptr), m_nextSize(0), m_capacity(0),
+	m_parent(nullptr), m_cellsVisited(0), m_levels(0) {
+
+	m_words = (int)(((long long)rows * cols + 63) / 64);
+	m_visited = new std::atomic<uint64_t>[m_words];
+}
+
+ParallelBfs::~ParallelBfs() {
+	delete[] m_visited;
+	delete[] m_frontier;
+	delete[] m_next;
+	delete[] m_parent;
+}
+
+int ParallelBfs::cellsVisited() const {
+	return m_cellsVisited;
+}
+int ParallelBfs::levels() const {
+	return m_levels;
+}
+
+bool ParallelBfs::claim(int cell) {
+	uint64_t bit = (uint64_t)1 << (cell & 63);
+	std::atomic<uint64_t>& word = m_visited[cell >> 6];
+	// Plain load first, most neighbours are already taken
+	if (word.load(std::memory_order_relaxed) & bit)
+		return false;
+	return (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+}
+
+// Each frontier cell adds at most four cells, and never more than the
+// whole grid
+void ParallelBfs::reserveNext(int n) {
+	long long cells = (long long)m_rows * m_cols;
+	long long need = (long long)n * 4;
+	if (need > cells)
+		need = cells;
+	if (need <= m_capacity)
+		return;
+
+	int capacity = m_capacity < 1024 ? 1024 : m_capacity;
+	while (capacity < need)
+		capacity = capacity > cells / 2 ? (int)cells : capacity * 2;
+
+	int* frontier = new int[capacity];
+	if (m_frontierSize > 0)
+		memcpy(frontier, m_frontier, m_frontierSize * sizeof(int));
+	delete[] m_frontier;
+	delete[] m_next;
+	m_frontier = frontier;
+	m_next = new int[capacity];
+	m_capacity = capacity;
+}
+
+//  expandChunk()
+//		Claim the open, unvisited neighbours of a slice of the frontier.
+//		Claimed cells are gathered locally and copied into m_next in
+//		blocks, one atomic add per block instead of per cell.
+void ParallelBfs::expandChunk(int begin, int end) {
+	int local[BFS_LOCAL];
+	int nLocal = 0;
+
+	for (int i = begin; i < end; i++) {
+		int cell = m_frontier[i];
+		int x = cell % m_cols;
+		int y = cell / m_cols;
+
+		for (int d = 0; d < 4; d++) {
+			int nx = x + DX[d];
+			int ny = y + DY[d];
+			if ((unsigned)nx >= (unsigned)m_cols || (unsigned)ny >= (unsigned)m_rows)
+				continue;
+			int next = ny * m_cols + nx;
+			if (!m_open[next] || !claim(next))
+				continue;
+
+			if (m_parent != nullptr)
+				m_parent[next] = (unsigned char)(d ^ 1);	// W<->E, N<->S points back
+			local[nLocal++] = next;
+			if (nLocal == BFS_LOCAL) {
+				int at = m_nextSize.fetch_add(nLocal);
+				memcpy(m_next + at, local, nLocal * sizeof(int));
+				nLocal = 0;
+			}
+		}
+	}
+	if (nLocal > 0) {
+		int at = m_nextSize.fetch_add(nLocal);
+		memcpy(m_next + at, local, nLocal * sizeof(int));
+	}
+}
+
+//  solve()
+//		Expand level after level until the exit is claimed or the
+//		frontier runs dry.  The pool returns only when the whole level
+//		is done, that is the synchronisation between levels.
+int ParallelBfs::solve(Point start, Point end, ThreadPool* pool, PackedPath* path) {
+	for (int i = 0; i < m_words; i++)
+		m_visited[i].store(0, std::memory_order_relaxed);
+	m_cellsVisited = 0;
+	m_levels = 0;
+	if (path != nullptr)
+		path->clear(start);
+
+	long long cells = (long long)m_rows * m_cols;
+	if ((unsigned)start.getX() >= (unsigned)m_cols || (unsigned)start.getY() >= (unsigned)m_rows ||
+		(unsigned)end.getX() >= (unsigned)m_cols || (unsigned)end.getY() >= (unsigned)m_rows)
+		return -1;
+
+	delete[] m_parent;
+	m_parent = path != nullptr ? new unsigned char[cells] : nullptr;
+
+	int source = start.getY() * m_cols + start.getX();
+	int target = end.getY() * m_cols + end.getX();
+
+	m_frontierSize = 0;
+	reserveNext(1);
+	m_frontier[0] = source;
+	m_frontierSize = 1;
+	claim(source);
+	m_cellsVisited = 1;
+
+	int distance = source == target ? 0 : -1;
+	while (distance < 0 && m_frontierSize > 0) {
+		reserveNext(m_frontierSize);
+		m_nextSize.store(0);
+
+		if (pool != nullptr)
+			pool->parallelFor(m_frontierSize, BFS_GRAIN,
+				[this](int begin, int end) { expandChunk(begin, end); });
+		else
+			expandChunk(0, m_frontierSize);
+
+		m_levels++;
+		int* swap = m_frontier;
+		m_frontier = m_next;
+		m_next = swap;
+		m_frontierSize = m_nextSize.load();
+		m_cellsVisited += m_frontierSize;
+
+		if (m_visited[target >> 6].load(std::memory_order_relaxed) & ((uint64_t)1 << (target & 63)))
+			distance = m_levels;
+	}
+
+	// Walk the parent directions back from the exit, the path is
+	// distance steps long so it fills in from the back
+	if (path != nullptr && distance >= 0) {
+		path->resize(distance);
+		int cell = target;
+		for (int i = distance - 1; i >= 0; i--) {
+			int d = m_parent[cell];
+			path->set(i, d ^ 1);
+			cell += DY[d] * m_cols + DX[d];
+		}
+	}
+	return distance;
+}
+
+int ParallelBfs::solve(Point start, Point end, ThreadPool* pool, List<Point>* path) {
+	if (path == nullptr)
+		return solve(start, end, pool, (PackedPath*)nullptr);
+	PackedPath packed;
+	int distance = solve(start, end, pool, &packed);
+	if (distance >= 0)
+		packed.toPoints(*path);
+	else
+		*path = List<Point>();
+	return distance;
+}
@@ -0,0 +1,68 @@
+#ifndef PARALLELBFS_H
+#define PARALLELBFS_H
+
+#include<atomic>
+#include<cstdint>
+#include"point.h"
+#include"list.h"
+#include"packedpath.h"
+
+class ThreadPool;
+
+// Level synchronous breadth first search over an open cell mask, for
+// asking whether and how the exit is reachable without playing the
+// game out.
+//
+// Each level's frontier is cut into chunks for the pool's threads.  A
+// thread claims a neighbour by setting its bit in an atomic visited
+// bitmap, whoever flips the bit owns the cell and adds it to the next
+// frontier.  Distances are the same for any thread count, the path
+// returned is a shortest one but which one can vary between runs.
+class ParallelBfs {
+public:
+	// open is indexed by [y * cols + x] and must outlive the solver
+	ParallelBfs(const bool* open, int rows, int cols);
+	~ParallelBfs();
+
+	// Steps from start to end, -1 if end cannot be reached.  The start
+	// cell need not be open.  With a path, fills it start to end
+	// inclusive.  No pool runs on the calling thread.
+	int		solve(Point start, Point end, ThreadPool* pool = nullptr, List<Point>* path = nullptr);
+	// Same, with the path as direction codes
+	int		solve(Point start, Point end, ThreadPool* pool, PackedPath* path);
+
+	int		cellsVisited() const;	// By the last solve()
+	int		levels() const;			// Frontiers expanded by the last solve()
+
+private:
+	// Not copyable, owns its buffers
+	ParallelBfs(const ParallelBfs& other);
+	ParallelBfs& operator=(const ParallelBfs& other);
+
+	// Expand m_frontier[begin, end) into m_next
+	void	expandChunk(int begin, int end);
+	// Set cell's visited bit, true if this call set it
+	bool	claim(int cell);
+	// Make room for the next frontier of a frontier of n cells
+	void	reserveNext(int n);
+
+	const bool*	m_open;
+	int		m_rows;
+	int		m_cols;
+
+	std::atomic<uint64_t>* m_visited;	// One bit per cell
+	int		m_words;
+
+	int*	m_frontier;			// Cell indices of the level being expanded
+	int		m_frontierSize;
+	int*	m_next;				// Cells claimed for the next level
+	std::atomic<int> m_nextSize;
+	int		m_capacity;			// Of both frontier arrays
+
+	unsigned char* m_parent;	// Direction back to the parent, when tracing a path
+
+	int		m_cellsVisited;
+	int		m_levels;
+};
+
+#endif//PARALLELBFS_H
@@ -1,7 +1,5 @@
 #include"player.h"
 #include"actor.h"
-#include"stack.h"
-#include"list.h"
 #include"point.h"
 #include"aquarium.h"
 #include<iostream>
@@ -11,15 +9,77 @@
 //		Remembers and discovers the starting point.
 Player::Player(Aquarium* aquarium, Point p, std::string name, char sprite)
 	:Actor(aquarium, p, name, sprite),
-	m_look(),
-	m_discovered(),
+	m_search(new DepthFirstSearch(aquarium)),
+	m_steps(0),
+	m_frontierPeak(0),
+	m_backtrackPeak(0),
 	m_btQueue(),
 	m_btStack(),
 	m_toggleBackTracking(false) {
 
 	// Discover the starting point
-	m_discovered.push_front(p);
-	m_look.push(p);
+	m_search->start(p);
+}
+
+Player::~Player() {
+	delete m_search;
+}
+
+//  restart( ... )
+//		Reset the search to begin again at p.  The visited set is
+//		reset by epoch so this does not touch every cell.
+void Player::restart(Point p) {
+	m_btStack.clear();
+	m_btQueue.clear();
+	m_steps = 0;
+	m_frontierPeak = 0;
+	m_backtrackPeak = 0;
+
+	setPosition(p);
+	setState(State::LOOKING);
+	setInteract(Interact::ALONE);
+
+	m_search->start(p);
+}
+
+//  setSearch( ... )
+//		Swap in the strategy for kind and start over from here.
+void Player::setSearch(SearchKind kind) {
+	delete m_search;
+	m_search = createSearch(kind, getAquarium());
+	restart(getPosition());
+}
+
+SearchKind Player::getSearch() const {
+	return m_search->kind();
+}
+
+int Player::stepsTaken() const {
+	return m_steps;
+}
+
+int Player::nodesExpanded() const {
+	return m_search->nodesExpanded();
+}
+
+int Player::cellsDiscovered() const {
+	return m_search->cellsDiscovered();
+}
+
+int Player::frontierHighWater() const {
+	return m_frontierPeak;
+}
+
+int Player::backtrackHighWater() const {
+	return m_backtrackPeak;
+}
+
+int Player::allocations() const {
+	return m_search->allocations() + m_btStack.allocations();
+}
+
+bool Player::path(PackedPath& path) const {
+	return m_search->path(path);
 }
 
 //  stuck() 
@@ -41,16 +101,16 @@ void Player::toggleBackTrack(bool toggle) {
 
 //  getTargetPoint()
 //		Get the point the player wants to look around next.
-//      If m_look is empty then return an invalid point.
+//      If the search is exhausted then return an invalid point.
 Point Player::getTargetPoint() const {
-	if (m_look.empty()) return Point(-1, -1);
-	return m_look.peek();
+	if (m_search->empty()) return Point(-1, -1);
+	return m_search->target();
 }
 
 // discovered
-//		returns true if the item is in the list
+//		returns true if the item is in the set
 bool Player::discovered(const Point& p) const {
-	return (m_discovered.find(p) != -1);
+	return m_search->discovered(p);
 }
 
 
@@ -58,18 +118,18 @@ bool Player::discovered(const Point& p) const {
 // say()
 //		What does the player say?
 //		Already Implemented, nothing to do here
-void Player::say() {
+void Player::say(std::ostream& os) {
 
 	// Freedom supercedes being eaten
 	if (getState() == State::FREEDOM) {
-		std::cout << getName() << ": WEEEEEEEEE!";
+		os << getName() << ": WEEEEEEEEE!";
 		return;
 	}
 
 	// Being eaten supercedes being lost
 	switch (getInteract()) {
 	case Interact::ATTACK:
-		std::cout << getName() << ": OUCH!";
+		os << getName() << ": OUCH!";
 		break;
 	case Interact::GREET:
 		break;
@@ -77,13 +137,13 @@ void Player::say() {
 	default:
 		switch (getState()) {
 		case State::LOOKING:
-			std::cout << getName() << ": Where is the exit?";
+			os << getName() << ": Where is the exit?";
 			break;
 		case State::STUCK:
-			std::cout << getName() << ": Oh no! I am Trapped!";
+			os << getName() << ": Oh no! I am Trapped!";
 			break;
 		case State::BACKTRACK:
-			std::cout << getName() << ": Got to backtrack...";
+			os << getName() << ": Got to backtrack...";
 			break;
 		default:
 			break;
@@ -113,154 +173,57 @@ void Player::say() {
 //		Backtracking is challenging, save it for the very very very last thing.
 //		Make sure the STATE::LOOKING aspect compiles and works first.
 void Player::update() {
-	State playerState = State::LOOKING; {
-		setState(State::LOOKING);
-	}
-	if (m_toggleBackTracking == false) {
-	
-		setPosition(getTargetPoint());
-
-		//pop the top point off the stack
-		m_look.pop();
-
-		Point curr = getPosition();
-		int rows = getAquarium()->rows();
-		int cols = getAquarium()->cols();
-		int x = curr.getX();
-		int y = curr.getY();
-
+	setState(State::LOOKING);
+	m_steps++;
+
+	// Move to the next point to look around and pop it off
+	// the search.  The search discovers its open neighbours.
+	Point curr = getTargetPoint();
+	setPosition(curr);
+	m_search->pop();
+	m_search->expand(curr);
+	m_btStack.push(curr);
+	if (m_btStack.size() > m_backtrackPeak)
+		m_backtrackPeak = m_btStack.size();
+
+	if (m_toggleBackTracking == false || m_search->supportsBacktracking() == false) {
 		//if we are at endpoint, we are done
 		if (getAquarium()->getEndPoint() == curr) {
-			setState(State::FREEDOM); {
-			}
+			setState(State::FREEDOM);
 		}
-			   
-		// check west if safe and undiscovered then discover and push current point to stack and list. 
-		//else if push point to backstack.
-		curr.set(x - 1, y);
-		if (getAquarium()->isCellOpen(curr) && discovered(curr) == false) {
-			m_discovered.push_front(curr);
-			m_look.push(curr);
-		}
-		curr.set(x, y);
-
-		// check east if safe and undiscovered then discover and push current point to stack and list. 
-		//else if push point to backstack.
-		curr.set(x + 1, y);
-		if (getAquarium()->isCellOpen(curr) && discovered(curr) == false) {
-			m_discovered.push_front(curr);
-			m_look.push(curr);
-		}
-		curr.set(x, y);
-
-		// check north if safe and undiscovered then discover and push current point to stack and list. 
-		//else if push point to backstack.
-		curr.set(x, y - 1);
-		if (getAquarium()->isCellOpen(curr) && discovered(curr) == false) {
-			m_discovered.push_front(curr);
-			m_look.push(curr);
-		}
-		curr.set(x, y);
-
-		// check south if safe and undiscovered then discover and push current point to stack and list. 
-		//else if push point to backstack.
-		curr.set(x, y + 1);
-		if (getAquarium()->isCellOpen(curr) && discovered(curr) == false) {
-			m_discovered.push_front(curr);
-			m_look.push(curr);
-		}
-		curr.set(x, y);
-
-		setPosition(curr);
-		m_btStack.push(curr);
-
-		// if stack is empty - no solution
-		if (m_look.empty() == true) {
+		// if there is nowhere left to look - no solution
+		else if (m_search->empty() == true) {
 			setState(State::STUCK);
 		}
 	}
 
 	// start backtracking
 	else {
-		setPosition(getTargetPoint());
-
-		//pop the top point off the stack
-		m_look.pop();
-			   
-		Point curr = getPosition();
-		int rows = getAquarium()->rows();
-		int cols = getAquarium()->cols();
-		int x = curr.getX();
-		int y = curr.getY();
-
-		// check west if safe and undiscovered then discover and push current point to stack and list. 
-		//else if push point to backstack.
-		curr.set(x - 1, y);
-		if (getAquarium()->isCellOpen(curr) && discovered(curr) == false) {
-			m_discovered.push_front(curr);
-			m_look.push(curr);
-		}
-		curr.set(x, y);
-
-		// check east if safe and undiscovered then discover and push current point to stack and list. 
-		//else if push point to backstack.
-		curr.set(x + 1, y);
-		if (getAquarium()->isCellOpen(curr) && discovered(curr) == false) {
-			m_discovered.push_front(curr);
-			m_look.push(curr);
-		}
-		curr.set(x, y);
-
-		// check north if safe and undiscovered then discover and push current point to stack and list. 
-		//else if push point to backstack.
-		curr.set(x, y - 1);
-		if (getAquarium()->isCellOpen(curr) && discovered(curr) == false) {
-			m_discovered.push_front(curr);
-			m_look.push(curr);
-		}
-		curr.set(x, y);
-
-		// check south if safe and undiscovered then discover and push current point to stack and list. 
-		//else if push point to backstack.
-		curr.set(x, y + 1);
-		if (getAquarium()->isCellOpen(curr) && discovered(curr) == false) {
-			m_discovered.push_front(curr);
-			m_look.push(curr);
-		}
-		curr.set(x, y);
-
-		setPosition(curr);
-		m_btStack.push(curr);
-
 		// compare current to target
-		if ((curr.getX() == getTargetPoint().getX() && curr.getY() + 1 == getTargetPoint().getY()) |
-			(curr.getX() == getTargetPoint().getX() && curr.getY() - 1 == getTargetPoint().getY()) |
-			(curr.getX() +1 == getTargetPoint().getX() && curr.getY()  == getTargetPoint().getY()) |
-			(curr.getX() -1 == getTargetPoint().getX() && curr.getY()  == getTargetPoint().getY())) {
-
-		} 
-		else {
-			if (curr == m_btStack.peek()) {
-				State playerState = State::BACKTRACK; {
-					setState(State::BACKTRACK);
-				}
-				if (m_btStack.empty() == false && m_look.empty() == false) {
-					m_btStack.pop();
-					m_look.push(m_btStack.peek());
-					m_btStack.pop();
-				}
-				else {
-					State playerState = State::STUCK; {
-						setState(State::STUCK);
-					}
-				}
+		Point target = getTargetPoint();
+		int dx = curr.getX() - target.getX();
+		int dy = curr.getY() - target.getY();
+		bool adjacent = (dx == 0 && (dy == 1 || dy == -1)) || (dy == 0 && (dx == 1 || dx == -1));
+
+		// Not next to the target, step back to where we came from
+		// and look from there again
+		if (!adjacent) {
+			setState(State::BACKTRACK);
+			if (m_btStack.empty() == false && m_search->empty() == false) {
+				m_btStack.pop();
+				m_search->revisit(m_btStack.peek());
+				m_btStack.pop();
+			}
+			else {
+				setState(State::STUCK);
 			}
 		}
 		//if we are at endpoint, we are done
 		if (getAquarium()->getEndPoint() == curr) {
-			setState(State::FREEDOM); {
-			}
+			setState(State::FREEDOM);
 		}
 	}
-}
 
+	if (m_search->frontierSize() > m_frontierPeak)
+		m_frontierPeak = m_search->frontierSize();
+}
\ No newline at end of file
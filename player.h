@@ -2,9 +2,9 @@
 #define PLAYER_H
 
 #include"actor.h"
-#include"queue.h"
-#include"stack.h"
-#include"list.h"
+#include"arraystack.h"
+#include"ringqueue.h"
+#include"search.h"
 
 class Point;
 class Aquarium;
@@ -12,11 +12,12 @@ class Aquarium;
 class Player :public Actor {
 public:
 	Player(Aquarium* aquarium, Point p, std::string, char sprite);
+	virtual ~Player();
 
 	virtual void	update(); // The only function of player to implement
 
 
-	virtual void	say();
+	virtual void	say(std::ostream& os);
 
 	bool			foundExit() const;
 	bool			stuck() const;
@@ -24,20 +25,42 @@ public:
 
 	void			toggleBackTrack(bool toggle);
 
+	// Start a fresh search from p, forgets everything discovered
+	// so far without clearing the whole visited set
+	void			restart(Point p);
+
+	// Explore with a different search algorithm, restarts the
+	// search from the current position
+	void			setSearch(SearchKind kind);
+	SearchKind		getSearch() const;
+
+	// Cost of the run so far
+	int				stepsTaken() const;		// Calls to update()
+	int				nodesExpanded() const;	// Cells the search looked around
+	int				cellsDiscovered() const;
+	int				frontierHighWater() const;	// Most cells the search held at once
+	int				backtrackHighWater() const;	// Deepest m_btStack got
+	int				allocations() const;	// Blocks the search and m_btStack allocated
+
+	// The route the search found from where it started to the exit,
+	// false until the exit has been discovered
+	bool			path(PackedPath& path) const;
+
 #ifndef MAKE_MEMBERS_PUBLIC
 private:
 #endif
 
 	// Wrapper function to find if a point has been
-	// placed inside the m_discovered List
+	// discovered by the search
 	bool discovered(const Point& p) const;
 
-	// Stack to decide where to look next
-	Stack<Point>	m_look;
+	// Decides where to look next and remembers all the visited
+	// areas.  Depth first unless setSearch() picks another one.
+	SearchStrategy*	m_search;
 
-	// List to save all the visited areas, 
-	// Helps us decide where to look next
-	List<Point>		m_discovered;
+	int				m_steps;
+	int				m_frontierPeak;
+	int				m_backtrackPeak;
 
 	// ** Variables relating to backtracking. **
 	// Backtracking here is defined as "smooth" movement between
@@ -46,6 +69,8 @@ private:
 	// All back tracking behavior should be toggled using
 	// m_toggleBackTracking, if false the player teleports
 	// the way seen in the algorithm from the lecture slides.
+	// Only depth first search backtracks, with the other
+	// strategies the player always teleports.
 	bool			m_toggleBackTracking;
 
 	// Used to facilitate backtracking, without backtracking, 
@@ -62,8 +87,8 @@ private:
 	//
 	// You may or may not need one or both.  It depends on how you 
 	// plan your backtracking algorithm.  
-	Stack<Point>	m_btStack;
-	Queue<Point>	m_btQueue;
+	ArrayStack<Point>	m_btStack;
+	RingQueue<Point>	m_btQueue;
 
 };
 
@@ -0,0 +1,158 @@
+#include"renderer.h"
+#include<iostream>
+#include<cstdlib>
+#include<cstring>
+
+#ifdef _MSC_VER  //  Microsoft Visual C++
+#include <windows.h>
+#endif
+
+// ANSI Terminal esc seq:  ESC [
+static const char* ESC_SEQ = "\x1B[";
+
+// Changed cells closer together than this are sent as one run, a
+// cursor move costs about as much as resending a few cells
+static const int MAX_GAP = 4;
+
+bool parseRenderMode(const std::string& name, RenderMode& mode) {
+	if (name == "full")
+		mode = RenderMode::FULL;
+	else if (name == "diff")
+		mode = RenderMode::DIFF;
+	else
+		return false;
+	return true;
+}
+
+// Can the terminal take escape sequences?  Same test as clearScreen(),
+// on Windows ask the console to interpret them.
+static bool ansiTerminal() {
+#ifdef _MSC_VER
+	HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD mode = 0;
+	if (!GetConsoleMode(hConsole, &mode))
+		return false;
+	return SetConsoleMode(hConsole, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) != 0;
+#else
+	const char* term = getenv("TERM");
+	return !(term == nullptr || strcmp(term, "dumb") == 0);
+#endif
+}
+
+Renderer::Renderer(RenderMode mode)
+	:m_mode(mode), m_ansi(ansiTerminal()), m_havePrevious(false) {
+}
+
+RenderMode Renderer::mode() const {
+	return m_mode;
+}
+
+size_t Renderer::lastFrameBytes() const {
+	return m_out.size();
+}
+
+std::string& Renderer::beginFrame() {
+	m_frame.clear();
+	return m_frame;
+}
+
+void Renderer::present() {
+	m_out.clear();
+
+	if (!m_ansi) {
+		m_out += '\n';
+		m_out += m_frame;
+	}
+	else if (m_mode == RenderMode::DIFF && m_havePrevious) {
+		diff();
+	}
+	else {
+		// Clear and home the cursor, then the whole frame
+		m_out += ESC_SEQ;
+		m_out += "2J";
+		m_out += ESC_SEQ;
+		m_out += "H";
+		m_out += m_frame;
+	}
+
+	std::cout.write(m_out.data(), m_out.size());
+	std::cout.flush();
+
+	m_previous.swap(m_frame);
+	m_havePrevious = true;
+}
+
+void Renderer::moveTo(int row, int col) {
+	m_out += ESC_SEQ;
+	m_out += std::to_string(row);
+	m_out += ';';
+	m_out += std::to_string(col);
+	m_out += 'H';
+}
+
+//  diff()
+//		Walk the old and new frame line by line.  Within a line collect
+//		runs of changed cells, jump to each run and write just the run.
+//		Lines that got shorter are erased to their end, and everything
+//		below the frame is erased so leftover prompts disappear.
+void Renderer::diff() {
+	const char* oldText = m_previous.data();
+	const char* oldEnd = oldText + m_previous.size();
+	const char* newText = m_frame.data();
+	const char* newEnd = newText + m_frame.size();
+
+	int row = 1;
+	while (newText < newEnd) {
+		const char* newEol = (const char*)memchr(newText, '\n', newEnd - newText);
+		if (newEol == nullptr) newEol = newEnd;
+		const char* oldEol = oldText;
+		if (oldText < oldEnd) {
+			oldEol = (const char*)memchr(oldText, '\n', oldEnd - oldText);
+			if (oldEol == nullptr) oldEol = oldEnd;
+		}
+		int newLen = (int)(newEol - newText);
+		int oldLen = (int)(oldEol - oldText);
+
+		// Runs of differing cells in the common part of the line
+		int common = newLen < oldLen ? newLen : oldLen;
+		int x = 0;
+		while (x < common) {
+			if (newText[x] == oldText[x]) {
+				x++;
+				continue;
+			}
+			int start = x, end = x + 1, gap = 0;
+			for (x++; x < common && gap <= MAX_GAP; x++) {
+				if (newText[x] != oldText[x]) {
+					end = x + 1;
+					gap = 0;
+				}
+				else {
+					gap++;
+				}
+			}
+			moveTo(row, start + 1);
+			m_out.append(newText + start, end - start);
+			x = end;
+		}
+
+		// The line grew or shrank
+		if (newLen != oldLen) {
+			moveTo(row, common + 1);
+			m_out.append(newText + common, newLen - common);
+			if (newLen < oldLen) {
+				m_out += ESC_SEQ;
+				m_out += 'K';
+			}
+		}
+
+		newText = newEol < newEnd ? newEol + 1 : newEnd;
+		oldText = oldEol < oldEnd ? oldEol + 1 : oldEnd;
+		row++;
+	}
+
+	// Park the cursor under the frame and erase whatever is below
+	moveTo(row, 1);
+	m_out += ESC_SEQ;
+	m_out += 'J';
+}
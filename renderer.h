@@ -0,0 +1,49 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include<string>
+
+// How frames reach the terminal.
+//		FULL: clear the screen and write the whole frame.
+//		DIFF: only write what changed since the last frame, using
+//			  ANSI cursor moves.  Assumes the frame fits on screen.
+enum class RenderMode { FULL, DIFF };
+
+// "full", "diff" <-> RenderMode.
+// parseRenderMode returns false for an unknown name.
+bool		parseRenderMode(const std::string& name, RenderMode& mode);
+
+// Frame compositor.  A frame is built up as text in one buffer, then
+// present() sends it to the terminal with a single write.  On a dumb
+// terminal (or TERM unset) there are no escape sequences to use, so
+// every frame is written in full after a newline, like clearScreen().
+class Renderer {
+public:
+	Renderer(RenderMode mode);
+
+	// Start a new frame, returns the buffer to append it to
+	std::string& beginFrame();
+
+	// Write the frame out and remember it for the next diff
+	void		present();
+
+	RenderMode	mode() const;
+
+	// Bytes written by the last present(), to compare the modes
+	size_t		lastFrameBytes() const;
+
+private:
+	// Append the escape sequences turning m_previous into m_frame
+	void		diff();
+	// Append a cursor move to 1 based row, col
+	void		moveTo(int row, int col);
+
+	RenderMode	m_mode;
+	bool		m_ansi;			// Terminal understands escape sequences
+	bool		m_havePrevious;	// m_previous is what is on screen
+	std::string m_frame;		// Frame being built
+	std::string m_previous;		// Last frame presented
+	std::string m_out;			// Bytes to write for this frame
+};
+
+#endif//RENDERER_H
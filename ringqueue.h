@@ -0,0 +1,262 @@
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H
+
+#include<iostream>
+#include<assert.h>
+#include<new>
+#include<utility>
+
+// Queue ADT using a power of two ring buffer as primary data structure.
+//
+// Drop-in replacement for Queue: same push/pop/peek/empty/print.
+// Items wrap around one block, the front is found with a mask instead
+// of a modulo.  When the ring is full its capacity doubles (never below
+// MIN_CAPACITY), reserve() can size it up front.
+template<typename Type>
+class RingQueue {
+public:
+
+	RingQueue();
+	RingQueue(const RingQueue<Type>& other);
+	RingQueue(RingQueue<Type>&& other);
+	RingQueue<Type>& operator=(RingQueue<Type> other);
+	~RingQueue();
+
+	// Basic queue operations
+	void	push(const Type& item);
+	void	push(Type&& item);
+	template<typename... Args>
+	void	emplace(Args&&... args);
+	void	pop();
+
+	// Note that the user must first ensure the queue is not empty
+	// prior to calling these functions.
+	const Type& peek() const;
+	Type&		front();
+	const Type& front() const;
+
+	// Check to see if there is anything on the queue
+	bool	empty() const;
+	int		size() const;
+
+	// Make room for at least n items without further growth,
+	// rounded up to a power of two
+	void	reserve(int n);
+	int		capacity() const;
+	void	clear();
+
+	// Number of times the ring was (re)allocated
+	int		allocations() const;
+
+	// Use to see what is in the queue for debugging
+	void	print() const;
+
+	void	swap(RingQueue<Type>& other);
+
+#ifndef MAKE_MEMBERS_PUBLIC
+private:
+#endif
+
+	static const int MIN_CAPACITY = 16;
+
+	// Slot of the i-th item from the front
+	int		slot(int i) const;
+	void	grow();
+
+	Type*	m_data;		// Raw storage, m_size items from m_head on are constructed
+	int		m_head;		// Slot of the front item
+	int		m_size;
+	int		m_capacity;	// Always 0 or a power of two
+	int		m_allocations;
+};
+
+// RingQueue Implementation
+//
+
+// RingQueue() Default constructor:
+//		Starts with no storage, the first push allocates.
+template<typename Type>
+RingQueue<Type>::RingQueue() :m_data(nullptr), m_head(0), m_size(0), m_capacity(0), m_allocations(0) {}
+
+// Copy constructor:
+//		Copies the items in order, the copy starts at slot 0.
+template<typename Type>
+RingQueue<Type>::RingQueue(const RingQueue<Type>& other)
+	:m_data(nullptr), m_head(0), m_size(0), m_capacity(0), m_allocations(0) {
+	reserve(other.m_size);
+	for (int i = 0; i < other.m_size; i++)
+		push(other.m_data[other.slot(i)]);
+}
+
+// Move constructor:
+//		Takes over other's ring, leaves other empty.
+template<typename Type>
+RingQueue<Type>::RingQueue(RingQueue<Type>&& other)
+	:m_data(other.m_data), m_head(other.m_head), m_size(other.m_size),
+	m_capacity(other.m_capacity), m_allocations(other.m_allocations) {
+	other.m_data = nullptr;
+	other.m_head = other.m_size = other.m_capacity = 0;
+}
+
+// Assignment:
+//		other is already a copy (or moved in), swap with it.
+template<typename Type>
+RingQueue<Type>& RingQueue<Type>::operator=(RingQueue<Type> other) {
+	swap(other);
+	return *this;
+}
+
+template<typename Type>
+RingQueue<Type>::~RingQueue() {
+	clear();
+	::operator delete(m_data);
+}
+
+template<typename Type>
+int RingQueue<Type>::slot(int i) const {
+	return (m_head + i) & (m_capacity - 1);
+}
+
+template<typename Type>
+void RingQueue<Type>::grow() {
+	reserve(m_capacity < MIN_CAPACITY ? MIN_CAPACITY : m_capacity * 2);
+}
+
+// reserve():
+//		Move the items, unwrapped, into a ring of at least n slots.
+template<typename Type>
+void RingQueue<Type>::reserve(int n) {
+	if (n <= m_capacity)
+		return;
+	int capacity = MIN_CAPACITY;
+	while (capacity < n)
+		capacity *= 2;
+
+	Type* data = static_cast<Type*>(::operator new(capacity * sizeof(Type)));
+	m_allocations++;
+	for (int i = 0; i < m_size; i++) {
+		Type& item = m_data[slot(i)];
+		new (data + i) Type(std::move(item));
+		item.~Type();
+	}
+	::operator delete(m_data);
+	m_data = data;
+	m_head = 0;
+	m_capacity = capacity;
+}
+
+// push():
+//		Add item at the rear of the queue.
+template<typename Type>
+void RingQueue<Type>::push(const Type& item) {
+	if (m_size == m_capacity) {
+		// item may live in the ring that is about to move
+		Type copy(item);
+		grow();
+		new (m_data + slot(m_size++)) Type(std::move(copy));
+		return;
+	}
+	new (m_data + slot(m_size++)) Type(item);
+}
+
+template<typename Type>
+void RingQueue<Type>::push(Type&& item) {
+	if (m_size == m_capacity)
+		grow();
+	new (m_data + slot(m_size++)) Type(std::move(item));
+}
+
+// emplace():
+//		Construct an item at the rear of the queue in place.
+template<typename Type>
+template<typename... Args>
+void RingQueue<Type>::emplace(Args&&... args) {
+	if (m_size == m_capacity)
+		grow();
+	new (m_data + slot(m_size)) Type(std::forward<Args>(args)...);
+	m_size++;
+}
+
+// pop():
+//		Remove the item at the "front" of the queue.
+template<typename Type>
+void RingQueue<Type>::pop() {
+	if (m_size == 0)
+		return;
+	m_data[m_head].~Type();
+	m_head = slot(1);
+	m_size--;
+}
+
+// peek()/front():
+//		Look at the "front" of the queue without changing the
+//		Queue itself.
+template<typename Type>
+const Type& RingQueue<Type>::peek() const {
+	assert(m_size > 0);
+	return m_data[m_head];
+}
+
+template<typename Type>
+Type& RingQueue<Type>::front() {
+	assert(m_size > 0);
+	return m_data[m_head];
+}
+
+template<typename Type>
+const Type& RingQueue<Type>::front() const {
+	return peek();
+}
+
+template<typename Type>
+bool RingQueue<Type>::empty() const {
+	return m_size == 0;
+}
+
+template<typename Type>
+int RingQueue<Type>::size() const {
+	return m_size;
+}
+
+template<typename Type>
+int RingQueue<Type>::capacity() const {
+	return m_capacity;
+}
+
+template<typename Type>
+int RingQueue<Type>::allocations() const {
+	return m_allocations;
+}
+
+// clear():
+//		Remove every item, keeps the ring for reuse.
+template<typename Type>
+void RingQueue<Type>::clear() {
+	while (m_size > 0)
+		pop();
+	m_head = 0;
+}
+
+// print()
+//		Print to console the elements, front to rear like Queue.
+//		Used for debugging.
+template<typename Type>
+void RingQueue<Type>::print() const {
+	if (m_size == 0)
+		return;
+	std::cout << m_data[m_head];
+	for (int i = 1; i < m_size; i++)
+		std::cout << ' ' << m_data[slot(i)];
+	std::cout << std::endl;
+}
+
+template<typename Type>
+void RingQueue<Type>::swap(RingQueue<Type>& other) {
+	std::swap(m_data, other.m_data);
+	std::swap(m_head, other.m_head);
+	std::swap(m_size, other.m_size);
+	std::swap(m_capacity, other.m_capacity);
+	std::swap(m_allocations, other.m_allocations);
+}
+
+#endif//RINGQUEUE_H
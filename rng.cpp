@@ -0,0 +1,64 @@
+#include"rng.h"
+#include<random>
+
+// Golden ratio increment, separates the streams of one seed
+static const uint64_t STREAM_STEP = 0x9E3779B97F4A7C15ull;
+
+Rng::Rng(uint64_t seed) {
+	this->seed(seed);
+}
+
+//  seed()
+//		Expand seed into the 256 bit state with splitmix64, which
+//		never hands xoshiro the all zero state it cannot leave
+void Rng::seed(uint64_t seed) {
+	m_seed = seed;
+	uint64_t state = seed;
+	for (int i = 0; i < 4; i++)
+		m_s[i] = splitmix(state);
+}
+
+uint64_t Rng::getSeed() const {
+	return m_seed;
+}
+
+//  fill( ... )
+//		The range is worked out once and the loop stays inline, the
+//		rejection threshold is only needed on the rare low draws.
+void Rng::fill(int* out, int n, int min, int max) {
+	if (max < min) {
+		int t = max; max = min; min = t;
+	}
+	uint32_t range = (uint32_t)((int64_t)max - min) + 1;
+	if (range == 0) {
+		for (int i = 0; i < n; i++)
+			out[i] = (int)nextU32();
+		return;
+	}
+	for (int i = 0; i < n; i++) {
+		uint64_t m = (uint64_t)nextU32() * range;
+		if ((uint32_t)m < range) {
+			uint32_t threshold = (0u - range) % range;
+			while ((uint32_t)m < threshold)
+				m = (uint64_t)nextU32() * range;
+		}
+		out[i] = (int)(min + (int64_t)(m >> 32));
+	}
+}
+
+Rng Rng::stream(uint64_t id) const {
+	uint64_t state = m_seed ^ ((id + 1) * STREAM_STEP);
+	return Rng(splitmix(state));
+}
+
+uint64_t Rng::entropySeed() {
+	std::random_device rd;
+	return ((uint64_t)rd() << 32) ^ rd();
+}
+
+uint64_t Rng::splitmix(uint64_t& state) {
+	uint64_t z = (state += STREAM_STEP);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
@@ -0,0 +1,75 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include<cstdint>
+
+// Seedable random number generator, xoshiro256** seeded through
+// splitmix64.
+//
+// An Rng is a plain value: copy it to fork a stream, and give every
+// thread or actor its own so nobody shares or locks state.  stream(id)
+// derives independent per-thread or per-actor streams from a seed.  The same seed
+// always replays the same numbers, on every platform.
+//
+// next() and nextInt() are defined here so they inline in hot loops.
+class Rng {
+public:
+	explicit Rng(uint64_t seed = 0);
+
+	void		seed(uint64_t seed);	// Restart from seed
+	uint64_t	getSeed() const;
+
+	uint64_t	next() {
+		uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+		uint64_t t = m_s[1] << 17;
+		m_s[2] ^= m_s[0];
+		m_s[3] ^= m_s[1];
+		m_s[1] ^= m_s[2];
+		m_s[0] ^= m_s[3];
+		m_s[2] ^= t;
+		m_s[3] = rotl(m_s[3], 45);
+		return result;
+	}
+
+	uint32_t	nextU32() { return (uint32_t)(next() >> 32); }
+
+	// Uniform int from min to max, inclusive, same contract as randInt.
+	// Lemire's multiply and reject, no modulo bias and almost never a
+	// division.
+	int			nextInt(int min, int max) {
+		if (max < min) {
+			int t = max; max = min; min = t;
+		}
+		uint32_t range = (uint32_t)((int64_t)max - min) + 1;
+		if (range == 0)		// The full 32 bit range
+			return (int)nextU32();
+		uint64_t m = (uint64_t)nextU32() * range;
+		if ((uint32_t)m < range) {
+			uint32_t threshold = (0u - range) % range;
+			while ((uint32_t)m < threshold)
+				m = (uint64_t)nextU32() * range;
+		}
+		return (int)(min + (int64_t)(m >> 32));
+	}
+
+	// Fill out[0..n) with uniform ints from min to max, inclusive.  The
+	// same numbers, in the same order, as n calls to nextInt().
+	void		fill(int* out, int n, int min, int max);
+
+	// Independent stream number id of this generator's seed, the same
+	// (seed, id) always gives the same stream
+	Rng			stream(uint64_t id) const;
+
+	// A seed from std::random_device, for runs that need not replay
+	static uint64_t entropySeed();
+
+	static uint64_t splitmix(uint64_t& state);
+
+private:
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	uint64_t	m_s[4];
+	uint64_t	m_seed;
+};
+
+#endif//RNG_H
@@ -0,0 +1,630 @@
+#include"search.h"
+#include"aquarium.h"
+#include"distancefield.h"
+#include<assert.h>
+
+bool parseSearchKind(const std::string& name, SearchKind& kind) {
+	if (name == "dfs")
+		kind = SearchKind::DFS;
+	else if (name == "bfs")
+		kind = SearchKind::BFS;
+	else if (name == "astar")
+		kind = SearchKind::ASTAR;
+	else if (name == "bidirectional")
+		kind = SearchKind::BIDIRECTIONAL;
+	else if (name == "field")
+		kind = SearchKind::FIELD;
+	else if (name == "jps")
+		kind = SearchKind::JPS;
+	else
+		return false;
+	return true;
+}
+
+const char* searchKindName(SearchKind kind) {
+	switch (kind) {
+	case SearchKind::DFS:			return "dfs";
+	case SearchKind::BFS:			return "bfs";
+	case SearchKind::ASTAR:			return "astar";
+	case SearchKind::BIDIRECTIONAL:	return "bidirectional";
+	case SearchKind::FIELD:			return "field";
+	case SearchKind::JPS:			return "jps";
+	default:						return "unknown";
+	}
+}
+
+SearchStrategy* createSearch(SearchKind kind, const Aquarium* aquarium) {
+	switch (kind) {
+	case SearchKind::BFS:			return new BreadthFirstSearch(aquarium);
+	case SearchKind::ASTAR:			return new AStarSearch(aquarium);
+	case SearchKind::BIDIRECTIONAL:	return new BidirectionalSearch(aquarium);
+	case SearchKind::FIELD:			return new FieldSearch(aquarium);
+	case SearchKind::JPS:			return new JumpPointStrategy(aquarium);
+	case SearchKind::DFS:
+	default:						return new DepthFirstSearch(aquarium);
+	}
+}
+
+static int manhattan(const Point& a, const Point& b) {
+	int dx = a.getX() - b.getX();
+	int dy = a.getY() - b.getY();
+	return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+}
+
+
+// SearchStrategy
+//
+
+const int SearchStrategy::DX[4] = { -1, 1, 0, 0 };
+const int SearchStrategy::DY[4] = { 0, 0, -1, 1 };
+
+SearchStrategy::SearchStrategy(const Aquarium* aquarium)
+	:m_aquarium(aquarium), m_visited(aquarium->rows(), aquarium->cols()), m_expanded(0),
+	m_origin(), m_parent(new unsigned char[aquarium->rows() * aquarium->cols()]) {
+}
+
+SearchStrategy::~SearchStrategy() {
+	delete[] m_parent;
+}
+
+int SearchStrategy::index(const Point& p) const {
+	return p.getY() * m_aquarium->cols() + p.getX();
+}
+
+//  start( ... )
+//		Discover p and make it the first target.  The visited set is
+//		reset by epoch so this does not touch every cell.
+void SearchStrategy::start(Point p) {
+	m_visited.reset();
+	m_expanded = 0;
+	m_origin = p;
+	m_visited.set(p);
+	push(p, p);
+}
+
+//  expand( ... )
+//		Check west, east, north then south, if open and undiscovered
+//		discover it and hand it to the strategy.  Which ones are open
+//		comes from the bitboard in one go, bit d for direction d.
+void SearchStrategy::expand(Point p) {
+	m_expanded++;
+	unsigned open = m_aquarium->openBits().neighborMask(p.getX(), p.getY());
+	for (int d = 0; d < 4; d++) {
+		if ((open >> d & 1) == 0)
+			continue;
+		Point n(p.getX() + DX[d], p.getY() + DY[d]);
+		if (m_visited.testAndSet(n) == false) {
+			m_parent[index(n)] = (unsigned char)(d ^ 1);	// W<->E, N<->S points back
+			push(n, p);
+		}
+	}
+}
+
+bool SearchStrategy::supportsBacktracking() const {
+	return false;
+}
+
+void SearchStrategy::revisit(Point p) {
+	push(p, p);
+}
+
+bool SearchStrategy::discovered(const Point& p) const {
+	return m_visited.test(p);
+}
+
+bool SearchStrategy::path(PackedPath& path) const {
+	Point goal = m_aquarium->getEndPoint();
+	if (!discovered(goal)) {
+		path.clear(m_origin);
+		return false;
+	}
+	tracePath(goal, path);
+	return true;
+}
+
+//  tracePath( ... )
+//		Count the links back from p to the origin, then walk them again
+//		filling the path in from its last step.
+void SearchStrategy::tracePath(Point p, PackedPath& path) const {
+	int steps = 0;
+	for (Point q = p; q != m_origin; q = PackedPath::step(q, m_parent[index(q)]))
+		steps++;
+
+	path.clear(m_origin);
+	path.resize(steps);
+	Point q = p;
+	for (int i = steps - 1; i >= 0; i--) {
+		int d = m_parent[index(q)];
+		path.set(i, d ^ 1);
+		q = PackedPath::step(q, d);
+	}
+}
+
+int SearchStrategy::nodesExpanded() const {
+	return m_expanded;
+}
+
+int SearchStrategy::cellsDiscovered() const {
+	return m_visited.size();
+}
+
+
+// DepthFirstSearch
+//
+
+DepthFirstSearch::DepthFirstSearch(const Aquarium* aquarium)
+	:SearchStrategy(aquarium), m_look() {
+}
+
+SearchKind DepthFirstSearch::kind() const {
+	return SearchKind::DFS;
+}
+
+void DepthFirstSearch::start(Point p) {
+	m_look.clear();
+	SearchStrategy::start(p);
+}
+
+bool DepthFirstSearch::empty() const {
+	return m_look.empty();
+}
+
+Point DepthFirstSearch::target() const {
+	return m_look.peek();
+}
+
+void DepthFirstSearch::pop() {
+	m_look.pop();
+}
+
+int DepthFirstSearch::frontierSize() const {
+	return m_look.size();
+}
+
+int DepthFirstSearch::allocations() const {
+	return m_look.allocations();
+}
+
+bool DepthFirstSearch::supportsBacktracking() const {
+	return true;
+}
+
+void DepthFirstSearch::revisit(Point p) {
+	m_look.push(p);
+}
+
+void DepthFirstSearch::push(Point p, Point /*from*/) {
+	m_look.push(p);
+}
+
+
+// BreadthFirstSearch
+//
+
+BreadthFirstSearch::BreadthFirstSearch(const Aquarium* aquarium)
+	:SearchStrategy(aquarium), m_frontier() {
+}
+
+SearchKind BreadthFirstSearch::kind() const {
+	return SearchKind::BFS;
+}
+
+void BreadthFirstSearch::start(Point p) {
+	m_frontier.clear();
+	SearchStrategy::start(p);
+}
+
+bool BreadthFirstSearch::empty() const {
+	return m_frontier.empty();
+}
+
+Point BreadthFirstSearch::target() const {
+	return m_frontier.peek();
+}
+
+void BreadthFirstSearch::pop() {
+	m_frontier.pop();
+}
+
+int BreadthFirstSearch::frontierSize() const {
+	return m_frontier.size();
+}
+
+int BreadthFirstSearch::allocations() const {
+	return m_frontier.allocations();
+}
+
+void BreadthFirstSearch::push(Point p, Point /*from*/) {
+	m_frontier.push(p);
+}
+
+
+// AStarSearch
+//
+
+AStarSearch::AStarSearch(const Aquarium* aquarium)
+	:SearchStrategy(aquarium), m_heap(), m_g(new int[aquarium->rows() * aquarium->cols()]),
+	m_closed(aquarium->rows(), aquarium->cols()), m_order(0), m_goal(aquarium->getEndPoint()) {
+}
+
+AStarSearch::~AStarSearch() {
+	delete[] m_g;
+}
+
+SearchKind AStarSearch::kind() const {
+	return SearchKind::ASTAR;
+}
+
+void AStarSearch::start(Point p) {
+	m_heap.clear();
+	m_closed.reset();
+	m_order = 0;
+	SearchStrategy::start(p);
+}
+
+bool AStarSearch::empty() const {
+	return m_heap.empty();
+}
+
+Point AStarSearch::target() const {
+	return m_heap[0].p;
+}
+
+//  pop()
+//		The target is about to be expanded, close it.
+void AStarSearch::pop() {
+	m_closed.set(m_heap[0].p);
+	heapPop();
+	skipStale();
+}
+
+// Stale entries included, they take up room all the same
+int AStarSearch::frontierSize() const {
+	return m_heap.size();
+}
+
+int AStarSearch::allocations() const {
+	return m_heap.allocations();
+}
+
+//  expand( ... )
+//		Unlike the other strategies a discovered cell can be pushed
+//		again if it is reached by a shorter route.  The stale entry is
+//		dropped when it reaches the top of the heap.
+void AStarSearch::expand(Point p) {
+	m_expanded++;
+	int g = m_g[index(p)] + 1;
+	unsigned open = m_aquarium->openBits().neighborMask(p.getX(), p.getY());
+	for (int d = 0; d < 4; d++) {
+		if ((open >> d & 1) == 0)
+			continue;
+		Point n(p.getX() + DX[d], p.getY() + DY[d]);
+		if (m_closed.test(n))
+			continue;
+		if (m_visited.testAndSet(n) && m_g[index(n)] <= g)
+			continue;
+		m_g[index(n)] = g;
+		m_parent[index(n)] = (unsigned char)(d ^ 1);
+		int h = manhattan(n, m_goal);
+		Entry e = { g + h, h, g, m_order++, n };
+		heapPush(e);
+	}
+	skipStale();
+}
+
+void AStarSearch::push(Point p, Point from) {
+	int g = (p == from) ? 0 : m_g[index(from)] + 1;
+	m_g[index(p)] = g;
+	int h = manhattan(p, m_goal);
+	Entry e = { g + h, h, g, m_order++, p };
+	heapPush(e);
+}
+
+bool AStarSearch::before(const Entry& a, const Entry& b) {
+	if (a.f != b.f) return a.f < b.f;
+	if (a.h != b.h) return a.h < b.h;
+	return a.order > b.order;
+}
+
+void AStarSearch::heapPush(const Entry& e) {
+	m_heap.push(e);
+	int i = m_heap.size() - 1;
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!before(m_heap[i], m_heap[parent]))
+			break;
+		std::swap(m_heap[i], m_heap[parent]);
+		i = parent;
+	}
+}
+
+void AStarSearch::heapPop() {
+	int n = m_heap.size() - 1;
+	m_heap[0] = m_heap[n];
+	m_heap.pop();
+	int i = 0;
+	while (true) {
+		int best = i;
+		int l = 2 * i + 1, r = l + 1;
+		if (l < n && before(m_heap[l], m_heap[best])) best = l;
+		if (r < n && before(m_heap[r], m_heap[best])) best = r;
+		if (best == i)
+			break;
+		std::swap(m_heap[i], m_heap[best]);
+		i = best;
+	}
+}
+
+void AStarSearch::skipStale() {
+	while (!m_heap.empty()) {
+		const Entry& top = m_heap[0];
+		if (!m_closed.test(top.p) && top.g <= m_g[index(top.p)])
+			break;
+		heapPop();
+	}
+}
+
+
+// BidirectionalSearch
+//
+
+BidirectionalSearch::BidirectionalSearch(const Aquarium* aquarium)
+	:SearchStrategy(aquarium), m_frontier(), m_backFrontier(),
+	m_backVisited(aquarium->rows(), aquarium->cols()),
+	m_backParent(new char[aquarium->rows() * aquarium->cols()]),
+	m_route(), m_met(false), m_meet() {
+}
+
+BidirectionalSearch::~BidirectionalSearch() {
+	delete[] m_backParent;
+}
+
+SearchKind BidirectionalSearch::kind() const {
+	return SearchKind::BIDIRECTIONAL;
+}
+
+void BidirectionalSearch::start(Point p) {
+	m_frontier.clear();
+	m_backFrontier.clear();
+	m_route.clear();
+	m_met = false;
+
+	// Seed the search out of the exit first, so start() can
+	// already notice a start sitting on the exit
+	Point goal = m_aquarium->getEndPoint();
+	m_backVisited.reset();
+	m_backVisited.set(goal);
+	m_backFrontier.push(goal);
+
+	SearchStrategy::start(p);
+}
+
+bool BidirectionalSearch::empty() const {
+	return m_met ? m_route.empty() : m_frontier.empty();
+}
+
+Point BidirectionalSearch::target() const {
+	return m_met ? m_route.peek() : m_frontier.peek();
+}
+
+void BidirectionalSearch::pop() {
+	if (m_met)
+		m_route.pop();
+	else
+		m_frontier.pop();
+}
+
+// Both searches until they meet, then the route left to walk
+int BidirectionalSearch::frontierSize() const {
+	return m_met ? m_route.size() : m_frontier.size() + m_backFrontier.size();
+}
+
+int BidirectionalSearch::allocations() const {
+	return m_frontier.allocations() + m_backFrontier.allocations() + m_route.allocations();
+}
+
+//  expand( ... )
+//		One cell out of the start, which the Player stands on, then one
+//		cell out of the exit.  Nothing left to search once they met.
+void BidirectionalSearch::expand(Point p) {
+	if (m_met)
+		return;
+	SearchStrategy::expand(p);
+	if (!m_met)
+		expandBackward();
+}
+
+void BidirectionalSearch::push(Point p, Point /*from*/) {
+	if (m_met)
+		return;
+	if (m_backVisited.test(p)) {
+		meet(p);
+		return;
+	}
+	m_frontier.push(p);
+}
+
+void BidirectionalSearch::expandBackward() {
+	if (m_backFrontier.empty())
+		return;
+	Point p = m_backFrontier.peek();
+	m_backFrontier.pop();
+	m_expanded++;
+
+	unsigned open = m_aquarium->openBits().neighborMask(p.getX(), p.getY());
+	for (int d = 0; d < 4; d++) {
+		if ((open >> d & 1) == 0)
+			continue;
+		Point n(p.getX() + DX[d], p.getY() + DY[d]);
+		if (m_backVisited.testAndSet(n))
+			continue;
+		// Step from n back to p is the opposite of d: W<->E, N<->S
+		m_backParent[index(n)] = (char)(d ^ 1);
+		if (m_visited.test(n)) {
+			meet(n);
+			return;
+		}
+		m_backFrontier.push(n);
+	}
+}
+
+void BidirectionalSearch::meet(Point p) {
+	m_met = true;
+	m_meet = p;
+	m_frontier.clear();
+	m_backFrontier.clear();
+
+	Point goal = m_aquarium->getEndPoint();
+	m_route.push(p);
+	while (p != goal) {
+		int d = m_backParent[index(p)];
+		p.set(p.getX() + DX[d], p.getY() + DY[d]);
+		m_route.push(p);
+	}
+}
+
+
+//  path( ... )
+//		The forward links from the start to the meeting point, then the
+//		backward links on to the exit.
+bool BidirectionalSearch::path(PackedPath& path) const {
+	if (!m_met) {
+		path.clear(m_origin);
+		return false;
+	}
+	tracePath(m_meet, path);
+	Point goal = m_aquarium->getEndPoint();
+	for (Point p = m_meet; p != goal; ) {
+		int d = m_backParent[index(p)];
+		path.push(d);
+		p = PackedPath::step(p, d);
+	}
+	return true;
+}
+
+
+// FieldSearch
+//
+
+FieldSearch::FieldSearch(const Aquarium* aquarium)
+	:SearchStrategy(aquarium), m_field(&aquarium->distanceField()), m_next(), m_haveNext(false) {
+}
+
+SearchKind FieldSearch::kind() const {
+	return SearchKind::FIELD;
+}
+
+void FieldSearch::start(Point p) {
+	m_haveNext = false;
+	SearchStrategy::start(p);
+}
+
+bool FieldSearch::empty() const {
+	return !m_haveNext;
+}
+
+Point FieldSearch::target() const {
+	return m_next;
+}
+
+void FieldSearch::pop() {
+	m_haveNext = false;
+}
+
+//  expand( ... )
+//		Only the neighbour downhill is discovered, nothing at the exit
+//		or where the exit cannot be reached.
+void FieldSearch::expand(Point p) {
+	m_expanded++;
+	int d = m_field->downhill(p);
+	if (d < 0)
+		return;
+	Point n = PackedPath::step(p, d);
+	if (m_visited.testAndSet(n) == false) {
+		m_parent[index(n)] = (unsigned char)(d ^ 1);
+		push(n, p);
+	}
+}
+
+int FieldSearch::frontierSize() const {
+	return m_haveNext ? 1 : 0;
+}
+
+int FieldSearch::allocations() const {
+	return 0;
+}
+
+void FieldSearch::push(Point p, Point /*from*/) {
+	m_next = p;
+	m_haveNext = true;
+}
+
+
+// JumpPointStrategy
+//
+
+JumpPointStrategy::JumpPointStrategy(const Aquarium* aquarium)
+	:SearchStrategy(aquarium), m_jps(aquarium->openBits()), m_route(), m_found(false),
+	m_walked(0), m_next(), m_haveNext(false) {
+}
+
+SearchKind JumpPointStrategy::kind() const {
+	return SearchKind::JPS;
+}
+
+//  start( ... )
+//		The whole search happens here, the rest is walking the route
+void JumpPointStrategy::start(Point p) {
+	m_haveNext = false;
+	m_walked = 0;
+	SearchStrategy::start(p);
+	m_found = m_jps.solve(p, m_aquarium->getEndPoint(), &m_route) >= 0;
+	m_expanded = m_jps.nodesExpanded();
+}
+
+bool JumpPointStrategy::empty() const {
+	return !m_haveNext;
+}
+
+Point JumpPointStrategy::target() const {
+	return m_next;
+}
+
+void JumpPointStrategy::pop() {
+	m_haveNext = false;
+}
+
+//  expand( ... )
+//		Discover the next cell of the route, nothing past the exit or
+//		when there is no route.
+void JumpPointStrategy::expand(Point p) {
+	if (m_walked >= m_route.size())
+		return;
+	int d = m_route.dir(m_walked++);
+	Point n = PackedPath::step(p, d);
+	m_visited.set(n);
+	m_parent[index(n)] = (unsigned char)(d ^ 1);
+	push(n, p);
+}
+
+bool JumpPointStrategy::path(PackedPath& path) const {
+	if (!m_found) {
+		path.clear(m_origin);
+		return false;
+	}
+	path = m_route;
+	return true;
+}
+
+int JumpPointStrategy::frontierSize() const {
+	return m_haveNext ? 1 : 0;
+}
+
+int JumpPointStrategy::allocations() const {
+	return m_jps.allocations();
+}
+
+void JumpPointStrategy::push(Point p, Point /*from*/) {
+	m_next = p;
+	m_haveNext = true;
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include"point.h"
+#include"visited.h"
+#include"arraystack.h"
+#include"ringqueue.h"
+#include"packedpath.h"
+#include"jumppoint.h"
+#include<string>
+
+class Aquarium;
+class DistanceField;
+
+// The search algorithms the Player can explore the aquarium with
+enum class SearchKind { DFS, BFS, ASTAR, BIDIRECTIONAL, FIELD, JPS };
+
+// "dfs", "bfs", "astar", "bidirectional", "field", "jps" <-> SearchKind.
+// parseSearchKind returns false for an unknown name.
+bool		parseSearchKind(const std::string& name, SearchKind& kind);
+const char* searchKindName(SearchKind kind);
+
+// Strategy deciding where the Player looks next.
+//
+// The Player keeps the one move per update() contract: every update
+// it takes target(), pop()s it, moves there and calls expand() on it
+// so the strategy can discover the open neighbours.  The strategies
+// only differ in the order they hand the discovered cells back out.
+class SearchStrategy {
+public:
+	SearchStrategy(const Aquarium* aquarium);
+	virtual ~SearchStrategy();
+
+	virtual SearchKind kind() const = 0;
+
+	// Forget everything and begin a new search at p
+	virtual void	start(Point p);
+
+	// Note that the user must first ensure the strategy is not empty
+	// prior to calling target() or pop().
+	virtual bool	empty() const = 0;
+	virtual Point	target() const = 0;
+	virtual void	pop() = 0;
+
+	// Discover the open, undiscovered neighbours of p
+	virtual void	expand(Point p);
+
+	// Walking back cell by cell only makes sense for DFS, where the
+	// next target is always next to somewhere already visited.
+	virtual bool	supportsBacktracking() const;
+	// Make p the next target without discovering it again
+	virtual void	revisit(Point p);
+
+	bool			discovered(const Point& p) const;
+
+	// Route from where the search started to the exit along the links
+	// every cell keeps to the cell it was discovered from.  False, and
+	// path left empty, until the exit has been discovered.  Found by
+	// the search, so shortest only for BFS, A* and bidirectional.
+	virtual bool	path(PackedPath& path) const;
+
+	int				nodesExpanded() const;	// Calls to expand()
+	int				cellsDiscovered() const;
+
+	// Cells waiting to be looked at, and blocks the containers
+	// holding them allocated so far
+	virtual int		frontierSize() const = 0;
+	virtual int		allocations() const = 0;
+
+protected:
+	// A cell was discovered from the cell it was reached from
+	virtual void	push(Point p, Point from) = 0;
+
+	// Route from m_origin to p, which must have been discovered
+	void			tracePath(Point p, PackedPath& path) const;
+
+	int				index(const Point& p) const;
+
+	// Neighbour offsets in the order they are discovered: W, E, N, S
+	static const int DX[4];
+	static const int DY[4];
+
+	const Aquarium* m_aquarium;
+	VisitedSet		m_visited;
+	int				m_expanded;
+	Point			m_origin;		// Where start() began the search
+	unsigned char*	m_parent;		// Direction back to the cell each was discovered from
+
+private:
+	// Not copyable
+	SearchStrategy(const SearchStrategy& other);
+	SearchStrategy& operator=(const SearchStrategy& other);
+};
+
+// Depth first, the lecture algorithm: the most recently discovered
+// cell is looked at next.
+class DepthFirstSearch : public SearchStrategy {
+public:
+	DepthFirstSearch(const Aquarium* aquarium);
+
+	virtual SearchKind kind() const;
+	virtual void	start(Point p);
+	virtual bool	empty() const;
+	virtual Point	target() const;
+	virtual void	pop();
+	virtual bool	supportsBacktracking() const;
+	virtual void	revisit(Point p);
+
+	virtual int		frontierSize() const;
+	virtual int		allocations() const;
+
+protected:
+	virtual void	push(Point p, Point from);
+
+private:
+	ArrayStack<Point> m_look;
+};
+
+// Breadth first: cells are looked at in the order they were
+// discovered, so the exit is reached by a shortest route.
+class BreadthFirstSearch : public SearchStrategy {
+public:
+	BreadthFirstSearch(const Aquarium* aquarium);
+
+	virtual SearchKind kind() const;
+	virtual void	start(Point p);
+	virtual bool	empty() const;
+	virtual Point	target() const;
+	virtual void	pop();
+
+	virtual int		frontierSize() const;
+	virtual int		allocations() const;
+
+protected:
+	virtual void	push(Point p, Point from);
+
+private:
+	RingQueue<Point> m_frontier;
+};
+
+// A*: looks at the cell with the lowest distance so far plus
+// Manhattan distance to Aquarium::getEndPoint().  Ties go to the
+// cell closer to the exit, then to the most recently discovered.
+class AStarSearch : public SearchStrategy {
+public:
+	AStarSearch(const Aquarium* aquarium);
+	virtual ~AStarSearch();
+
+	virtual SearchKind kind() const;
+	virtual void	start(Point p);
+	virtual bool	empty() const;
+	virtual Point	target() const;
+	virtual void	pop();
+	virtual void	expand(Point p);
+
+	virtual int		frontierSize() const;
+	virtual int		allocations() const;
+
+protected:
+	virtual void	push(Point p, Point from);
+
+private:
+	struct Entry {
+		int			f;		// g + h
+		int			h;		// Manhattan distance to the exit
+		int			g;		// Steps from the start when pushed
+		unsigned	order;	// Push order, later wins ties
+		Point		p;
+	};
+
+	// Does a belong above b in the heap
+	static bool	before(const Entry& a, const Entry& b);
+	void		heapPush(const Entry& e);
+	void		heapPop();
+	// Drop entries superseded by a shorter route or already expanded
+	void		skipStale();
+
+	ArrayStack<Entry> m_heap;	// Binary min-heap, ArrayStack for the storage
+	int*		m_g;			// Best known steps from the start, valid if discovered
+	VisitedSet	m_closed;		// Cells already expanded
+	unsigned	m_order;
+	Point		m_goal;
+};
+
+// Bidirectional breadth first.  The Player's moves come from the
+// search out of the start; every expand() also expands one cell of a
+// second search out of the exit.  Once the two meet the rest of the
+// route is known, and the Player walks it one cell per update().
+class BidirectionalSearch : public SearchStrategy {
+public:
+	BidirectionalSearch(const Aquarium* aquarium);
+	virtual ~BidirectionalSearch();
+
+	virtual SearchKind kind() const;
+	virtual void	start(Point p);
+	virtual bool	empty() const;
+	virtual Point	target() const;
+	virtual void	pop();
+	virtual void	expand(Point p);
+	virtual bool	path(PackedPath& path) const;
+
+	virtual int		frontierSize() const;
+	virtual int		allocations() const;
+
+protected:
+	virtual void	push(Point p, Point from);
+
+private:
+	void		expandBackward();
+	// The searches met at p, queue the route from p to the exit
+	void		meet(Point p);
+
+	RingQueue<Point> m_frontier;	// Search out of the start
+	RingQueue<Point> m_backFrontier;	// Search out of the exit
+	VisitedSet	m_backVisited;
+	char*		m_backParent;		// Direction towards the exit, index into DX/DY
+	RingQueue<Point> m_route;		// Meeting point to exit, once met
+	bool		m_met;
+	Point		m_meet;				// Where the searches met
+};
+
+// Distance field: no exploring at all, every step goes to the
+// neighbour one closer to the exit on Aquarium::distanceField().  The
+// player walks a shortest route straight out, or is stuck at once if
+// there is none.
+class FieldSearch : public SearchStrategy {
+public:
+	FieldSearch(const Aquarium* aquarium);
+
+	virtual SearchKind kind() const;
+	virtual void	start(Point p);
+	virtual bool	empty() const;
+	virtual Point	target() const;
+	virtual void	pop();
+	virtual void	expand(Point p);
+
+	virtual int		frontierSize() const;
+	virtual int		allocations() const;
+
+protected:
+	virtual void	push(Point p, Point from);
+
+private:
+	const DistanceField* m_field;
+	Point		m_next;			// The one cell to look at next
+	bool		m_haveNext;
+};
+
+// Jump point search, run to the exit once when the search starts.
+// The Player then walks the route it found one cell per update(), the
+// way BidirectionalSearch walks its route once the two sides meet.
+// nodesExpanded() is the jump points the search expanded.
+class JumpPointStrategy : public SearchStrategy {
+public:
+	JumpPointStrategy(const Aquarium* aquarium);
+
+	virtual SearchKind kind() const;
+	virtual void	start(Point p);
+	virtual bool	empty() const;
+	virtual Point	target() const;
+	virtual void	pop();
+	virtual void	expand(Point p);
+	virtual bool	path(PackedPath& path) const;
+
+	virtual int		frontierSize() const;
+	virtual int		allocations() const;
+
+protected:
+	virtual void	push(Point p, Point from);
+
+private:
+	JumpPointSearch	m_jps;
+	PackedPath	m_route;		// Start to exit, empty if there is none
+	bool		m_found;
+	int			m_walked;		// Steps of m_route handed out so far
+	Point		m_next;
+	bool		m_haveNext;
+};
+
+// Dynamically allocates the strategy for kind
+SearchStrategy* createSearch(SearchKind kind, const Aquarium* aquarium);
+
+#endif//SEARCH_H
@@ -0,0 +1,185 @@
+#include"settings.h"
+#include"rng.h"
+#include<fstream>
+#include<algorithm>
+
+Settings::Settings() :mazeFile("maze_lecture.txt"), generateMaze(false),
+	mazeKind(MazeKind::BACKTRACKER), mazeRows(101), mazeCols(101), obstacleDensity(0.2),
+	havePlayerBackTack(true),
+	frameTimeDelay(500), numSharks(0), headless(false), search(SearchKind::DFS),
+	render(RenderMode::FULL), seed(Rng::entropySeed()), numThreads(1), metricsFile(), pathFile() {
+}
+
+// "true"/"false" into value, false if it is neither
+static bool parseBool(const std::string& text, bool& value) {
+	if (text != "true" && text != "false")
+		return false;
+	value = text == "true";
+	return true;
+}
+
+bool parseNumber(const std::string& text, long long& value) {
+	size_t used = 0;
+	try {
+		value = std::stoll(text, &used);
+	}
+	catch (const std::exception&) {
+		return false;
+	}
+	return used == text.size();
+}
+
+static std::string badFormat(const std::string& setting, const char* expected, const std::string& given) {
+	return setting + " setting incorrect format\n\tExpected: " + expected + ", given: ." + given + ".";
+}
+
+bool Settings::apply(const std::string& text, std::string& error) {
+	std::string line = text;
+	line.erase(std::remove_if(line.begin(), line.end(),
+		[](char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }), line.end());
+	if (line.size() == 0)
+		return true;
+	size_t delpos = line.find('=');
+	std::string setting = line.substr(0, delpos);
+	std::string value = delpos == std::string::npos ? "" : line.substr(delpos + 1);
+	long long number = 0;
+
+	if (setting == "mazeFile") {
+		std::ifstream tf(value);
+		if (!tf.is_open()) {
+			error = "could not open file " + value;
+			return false;
+		}
+		mazeFile = value;
+		generateMaze = false;
+	}
+	else if (setting == "generateMaze") {
+		if (!parseMazeKind(value, mazeKind)) {
+			error = badFormat(setting, "backtracker/prim/wilson/open", value);
+			return false;
+		}
+		generateMaze = true;
+	}
+	else if (setting == "mazeRows" || setting == "mazeCols") {
+		if (!parseNumber(value, number) || number < 3 || number > 0x7FFFFFFF) {
+			error = badFormat(setting, "3 or more", value);
+			return false;
+		}
+		(setting == "mazeRows" ? mazeRows : mazeCols) = (int)number;
+	}
+	else if (setting == "obstacleDensity") {
+		size_t used = 0;
+		double density = -1;
+		try {
+			density = std::stod(value, &used);
+		}
+		catch (const std::exception&) {
+			used = 0;
+		}
+		if (used == 0 || used != value.size() || !(density >= 0 && density < 1)) {
+			error = badFormat(setting, "0 up to but not including 1", value);
+			return false;
+		}
+		obstacleDensity = density;
+	}
+	else if (setting == "havePlayerBackTack") {
+		if (!parseBool(value, havePlayerBackTack)) {
+			error = badFormat(setting, "true/false", value);
+			return false;
+		}
+	}
+	else if (setting == "frameTimeDelay") {
+		if (!parseNumber(value, number)) {
+			error = badFormat(setting, "a number", value);
+			return false;
+		}
+		frameTimeDelay = (int)number;
+	}
+	else if (setting == "numSharks") {
+		if (!parseNumber(value, number) || number < 0) {
+			error = badFormat(setting, "0 or more", value);
+			return false;
+		}
+		numSharks = (int)number;
+	}
+	else if (setting == "numThreads") {
+		if (!parseNumber(value, number) || number < 0) {
+			error = badFormat(setting, "0 or more", value);
+			return false;
+		}
+		numThreads = (int)number;
+	}
+	else if (setting == "seed") {
+		if (value == "random")
+			seed = Rng::entropySeed();
+		else {
+			size_t used = 0;
+			try {
+				seed = std::stoull(value, &used);
+			}
+			catch (const std::exception&) {
+				used = 0;
+			}
+			if (used == 0 || used != value.size()) {
+				error = badFormat(setting, "a number or random", value);
+				return false;
+			}
+		}
+	}
+	else if (setting == "searchStrategy") {
+		if (!parseSearchKind(value, search)) {
+			error = badFormat(setting, "dfs/bfs/astar/bidirectional/field/jps", value);
+			return false;
+		}
+	}
+	else if (setting == "renderMode") {
+		if (!parseRenderMode(value, render)) {
+			error = badFormat(setting, "full/diff", value);
+			return false;
+		}
+	}
+	else if (setting == "metricsFile") {
+		metricsFile = value;
+	}
+	else if (setting == "pathFile") {
+		pathFile = value;
+	}
+	else if (setting == "headless") {
+		if (!parseBool(value, headless)) {
+			error = badFormat(setting, "true/false", value);
+			return false;
+		}
+	}
+	else {
+		error = "unknown setting " + setting + " " + value;
+		return false;
+	}
+	return true;
+}
+
+MazeSpec Settings::mazeSpec() const {
+	return MazeSpec(mazeKind, mazeRows, mazeCols, seed, obstacleDensity);
+}
+
+std::string Settings::mazeName() const {
+	if (!generateMaze)
+		return mazeFile;
+	return std::string(mazeKindName(mazeKind)) + " " + std::to_string(mazeRows)
+		+ "x" + std::to_string(mazeCols);
+}
+
+bool Settings::load(const std::string& filename, std::string& error) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		error = "could not open file " + filename;
+		return false;
+	}
+
+	//Grab settings from file
+	std::string line;
+	while (std::getline(file, line)) {
+		if (!apply(line, error))
+			return false;
+	}
+	return true;
+}
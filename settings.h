@@ -0,0 +1,63 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include<string>
+#include<cstdint>
+#include"search.h"
+#include"renderer.h"
+#include"mazegen.h"
+
+// Everything a Game is configured with.  Read from a settings file of
+// setting=value lines, blanks and whitespace ignored, or built up one
+// setting at a time (the batch runner's per maze overrides).
+struct Settings {
+	Settings();
+
+	// Apply one setting=value, false with error set if the setting is
+	// unknown or the value malformed
+	bool	apply(const std::string& line, std::string& error);
+
+	// Apply every line of a settings file
+	bool	load(const std::string& filename, std::string& error);
+
+	std::string mazeFile;
+
+	bool	generateMaze;		//Generate the maze in memory instead of mazeFile
+	MazeKind mazeKind;			//Using this generator, seeded from seed
+	int		mazeRows;
+	int		mazeCols;
+	double	obstacleDensity;	//Rock fraction of an open maze
+
+	bool	havePlayerBackTack;	//Toggle player backtracking
+
+	int		frameTimeDelay;		//Effects game speed, shorter delay
+								//less time between frames, faster 
+								//simulation when automating.
+	int		numSharks;
+
+	bool	headless;			//Run without drawing or input
+
+	SearchKind search;			//How the player explores
+
+	RenderMode render;			//Redraw everything or only changes
+
+	uint64_t seed;				//Same seed, same sharks, "random" for a fresh one
+
+	int		numThreads;			//Threads moving sharks, 0 for all cores
+
+	std::string metricsFile;	//Phase latencies and counters written here
+								//at the end of play(), .csv or JSON.
+								//Empty for none.
+
+	std::string pathFile;		//Route the player found written here at
+								//the end of play(), empty for none
+
+	MazeSpec mazeSpec() const;	// What to generate when generateMaze
+	std::string mazeName() const;	// mazeFile, or what generates the maze
+};
+
+// Whole of text as a number into value, false if it is not one.  How
+// settings and command line numbers are read.
+bool	parseNumber(const std::string& text, long long& value);
+
+#endif//SETTINGS_H
@@ -1,54 +1,286 @@
 #include"shark.h"
-#include"aquarium.h"
-#include"player.h"
-#include"utils.h"
-Shark::Shark(Aquarium* aquarium, Point p, std::string name, char sprite) :
-	Actor(aquarium, p, name, sprite) {
-}
-void Shark::update() {
-
-	// Pick a random direction
-	int dir = randInt(0, 3);
-	// Get a copy of sharks current position
-	Point p = getPosition();
-
-	int rows = getAquarium()->rows();
-	int cols = getAquarium()->cols();
-	int x = p.getX();
-	int y = p.getY();
-
-	// Check to see if desired direction is inbounds.
-	// Accounting for the Walls and one space to allow
-	// movement in that direction. Update the x,y
-	// coordinates or do nothing
-	switch (dir) {
-	case 0:  if (y <= 2)      return; else y--; break;
-	case 1:  if (y >= rows - 3) return; else y++; break;
-	case 2:  if (x <= 2)      return; else x--; break;
-	case 3:  if (x >= cols - 3) return; else x++; break;
-	default: return;
+#include"threadpool.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SHARK_AVX2
+#include<immintrin.h>
+#ifdef _MSC_VER  //  Microsoft Visual C++, intrinsics need no target flags
+#include<intrin.h>
+#define SHARK_TARGET_AVX2
+#else
+#define SHARK_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+static_assert(sizeof(bool) == 1, "the shark kernels read the open mask as bytes");
+
+// Constants of the direction hash
+static const unsigned SHARK_ID_MUL = 0x9E3779B1u;
+static const unsigned SHARK_STEP_MUL = 0x85EBCA77u;
+static const unsigned MIX_MUL1 = 0x7FEB352Du;
+static const unsigned MIX_MUL2 = 0x846CA68Bu;
+
+//  sharkDirection()
+//		Direction 0-3 for shark id on step, lowbias32 of the three
+//		mixed together.  Directions are the top two bits, the best
+//		mixed ones.
+static inline int sharkDirection(unsigned seed, unsigned id, unsigned step) {
+	unsigned h = seed ^ (id * SHARK_ID_MUL) ^ (step * SHARK_STEP_MUL);
+	h ^= h >> 16;
+	h *= MIX_MUL1;
+	h ^= h >> 15;
+	h *= MIX_MUL2;
+	h ^= h >> 16;
+	return (int)(h >> 30);
+}
+
+// One step of sharks [begin, end), read from the front buffer
+// and written to the back one
+struct SharkStep {
+	const int* xs;
+	const int* ys;
+	int*	outX;
+	int*	outY;
+	const bool* open;
+	int		rows;
+	int		cols;
+	unsigned seed;
+	unsigned step;
+};
+
+//  moveScalar()
+//		Move sharks [begin, end) one step
+static void moveScalar(const SharkStep& s, int begin, int end) {
+	const bool* open = s.open;
+	int rows = s.rows, cols = s.cols;
+
+	for (int i = begin; i < end; i++) {
+		// Pick a random direction
+		int dir = sharkDirection(s.seed, (unsigned)i, s.step);
+		int x = s.xs[i];
+		int y = s.ys[i];
+		s.outX[i] = x;
+		s.outY[i] = y;
+
+		// Check to see if desired direction is inbounds.
+		// Accounting for the Walls and one space to allow
+		// movement in that direction. Update the x,y
+		// coordinates or do nothing
+		switch (dir) {
+		case 0:  if (y <= 2)      continue; else y--; break;
+		case 1:  if (y >= rows - 3) continue; else y++; break;
+		case 2:  if (x <= 2)      continue; else x--; break;
+		case 3:  if (x >= cols - 3) continue; else x++; break;
+		default: continue;
+		}
+
+		// Check to see if new position is an open cell, the bounds
+		// above keep it inside the mask
+		if (!open[y * cols + x])
+			continue;
+
+		s.outX[i] = x;
+		s.outY[i] = y;
 	}
+}
 
-	// Check to see if new position is an open cell
-	p.set(x, y);
-	if (!getAquarium()->isCellOpen(p))
-		return;
+#ifdef SHARK_AVX2
+//  moveAvx2()
+//		Move sharks [begin, end) one step, eight lanes at a time with the
+//		same hash and rules as moveScalar.  Each rule becomes a lane
+//		mask, a blocked move is a move of zero, and the mask byte
+//		under every lane's target is gathered as a 32 bit word
+//		(hence SHARK_MASK_PAD).  The tail goes through moveScalar.
+SHARK_TARGET_AVX2
+static void moveAvx2(const SharkStep& s, int begin, int end) {
+	const int* xs = s.xs;
+	const int* ys = s.ys;
+	int rows = s.rows, cols = s.cols;
+	unsigned seed = s.seed, step = s.step;
 
-	setPosition(p);
+	const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i idMul = _mm256_set1_epi32((int)SHARK_ID_MUL);
+	const __m256i stepSeed = _mm256_set1_epi32((int)(seed ^ (step * SHARK_STEP_MUL)));
+	const __m256i mul1 = _mm256_set1_epi32((int)MIX_MUL1);
+	const __m256i mul2 = _mm256_set1_epi32((int)MIX_MUL2);
+	const __m256i two = _mm256_set1_epi32(2);
+	const __m256i rowLimit = _mm256_set1_epi32(rows - 3);
+	const __m256i colLimit = _mm256_set1_epi32(cols - 3);
+	const __m256i stride = _mm256_set1_epi32(cols);
+	const __m256i byte = _mm256_set1_epi32(0xFF);
+	const __m256i zero = _mm256_setzero_si256();
+
+	int i = begin;
+	for (; i + 8 <= end; i += 8) {
+		__m256i id = _mm256_add_epi32(_mm256_set1_epi32(i), lane);
+		__m256i h = _mm256_xor_si256(_mm256_mullo_epi32(id, idMul), stepSeed);
+		h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+		h = _mm256_mullo_epi32(h, mul1);
+		h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+		h = _mm256_mullo_epi32(h, mul2);
+		h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+		__m256i dir = _mm256_srli_epi32(h, 30);
+
+		__m256i x = _mm256_loadu_si256((const __m256i*)(xs + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*)(ys + i));
+
+		// All ones in the lanes that may move that way
+		__m256i up = _mm256_and_si256(_mm256_cmpeq_epi32(dir, zero), _mm256_cmpgt_epi32(y, two));
+		__m256i down = _mm256_and_si256(_mm256_cmpeq_epi32(dir, _mm256_set1_epi32(1)), _mm256_cmpgt_epi32(rowLimit, y));
+		__m256i left = _mm256_and_si256(_mm256_cmpeq_epi32(dir, two), _mm256_cmpgt_epi32(x, two));
+		__m256i right = _mm256_and_si256(_mm256_cmpeq_epi32(dir, _mm256_set1_epi32(3)), _mm256_cmpgt_epi32(colLimit, x));
+
+		// All ones is -1, adding a mask steps back, subtracting steps on
+		__m256i ny = _mm256_sub_epi32(_mm256_add_epi32(y, up), down);
+		__m256i nx = _mm256_sub_epi32(_mm256_add_epi32(x, left), right);
+
+		__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(ny, stride), nx);
+		__m256i cell = _mm256_and_si256(_mm256_i32gather_epi32((const int*)s.open, index, 1), byte);
+		__m256i moved = _mm256_andnot_si256(_mm256_cmpeq_epi32(cell, zero),
+			_mm256_or_si256(_mm256_or_si256(up, down), _mm256_or_si256(left, right)));
+
+		_mm256_storeu_si256((__m256i*)(s.outX + i), _mm256_blendv_epi8(x, nx, moved));
+		_mm256_storeu_si256((__m256i*)(s.outY + i), _mm256_blendv_epi8(y, ny, moved));
+	}
+	moveScalar(s, i, end);
+}
+#endif
+
+bool SharkSchool::hasAvx2() {
+#ifndef SHARK_AVX2
+	return false;
+#elif defined(_MSC_VER)
+	// AVX2 needs the CPU to have it and the OS to save the ymm registers
+	static const bool avx2 = [] {
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+		__cpuid(info, 1);
+		const int osxsave = 1 << 27, avx = 1 << 28;
+		if ((info[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 6) != 6)
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}();
+	return avx2;
+#else
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	return avx2;
+#endif
 }
 
-void Shark::say() {
-	switch (getInteract()) {
+SharkSchool::SharkSchool() : m_x(), m_y(), m_nextX(), m_nextY(), m_state(), m_interact(),
+	m_sprite('S'), m_seed(0), m_step(0) {
+}
+int SharkSchool::add(Point p) {
+	m_x.push(p.getX());
+	m_y.push(p.getY());
+	m_nextX.push(p.getX());
+	m_nextY.push(p.getY());
+	m_state.push((unsigned char)State::LOOKING);
+	m_interact.push((unsigned char)Interact::ALONE);
+	return m_x.size() - 1;
+}
+int SharkSchool::size() const {
+	return m_x.size();
+}
+void SharkSchool::reserve(int n) {
+	m_x.reserve(n);
+	m_y.reserve(n);
+	m_nextX.reserve(n);
+	m_nextY.reserve(n);
+	m_state.reserve(n);
+	m_interact.reserve(n);
+}
+
+//  update()
+//		Move every shark one step in a random direction.  The loop
+//		only touches the x and y columns and the mask, no virtual
+//		calls and no per shark objects.
+//
+//		With a pool the school is cut into SHARK_GRAIN sized chunks.
+//		Every shark reads the front buffer and writes only its own
+//		back buffer slot, and its direction depends only on (seed,
+//		index, step), so the result is the same for any thread count.
+void SharkSchool::update(const bool* open, int rows, int cols, ThreadPool* pool) {
+	move(open, rows, cols, hasAvx2(), pool);
+}
+
+void SharkSchool::updateScalar(const bool* open, int rows, int cols) {
+	move(open, rows, cols, false, nullptr);
+}
+
+// Falls back to the scalar kernel when built without AVX2 support,
+// callers check hasAvx2() first
+void SharkSchool::updateAvx2(const bool* open, int rows, int cols) {
+	move(open, rows, cols, true, nullptr);
+}
+
+void SharkSchool::move(const bool* open, int rows, int cols, bool wide, ThreadPool* pool) {
+	int n = size();
+	if (n > 0) {
+		SharkStep s = { &m_x[0], &m_y[0], &m_nextX[0], &m_nextY[0], open, rows, cols, m_seed, m_step };
+#ifdef SHARK_AVX2
+		void (*kernel)(const SharkStep&, int, int) = wide ? moveAvx2 : moveScalar;
+#else
+		void (*kernel)(const SharkStep&, int, int) = moveScalar;
+		(void)wide;
+#endif
+		if (pool != nullptr)
+			pool->parallelFor(n, SHARK_GRAIN, [&](int begin, int end) { kernel(s, begin, end); });
+		else
+			kernel(s, 0, n);
+
+		// Back buffer becomes the new positions
+		m_x.swap(m_nextX);
+		m_y.swap(m_nextY);
+	}
+	m_step++;
+}
+
+void SharkSchool::setSeed(unsigned seed) {
+	m_seed = seed;
+	m_step = 0;
+}
+unsigned SharkSchool::getSeed() const {
+	return m_seed;
+}
+Point SharkSchool::getPosition(int i) const {
+	return Point(m_x[i], m_y[i]);
+}
+int SharkSchool::x(int i) const {
+	return m_x[i];
+}
+int SharkSchool::y(int i) const {
+	return m_y[i];
+}
+State SharkSchool::getState(int i) const {
+	return (State)m_state[i];
+}
+void SharkSchool::setInteract(int i, Interact interact) {
+	m_interact[i] = (unsigned char)interact;
+}
+Interact SharkSchool::getInteract(int i) const {
+	return (Interact)m_interact[i];
+}
+char SharkSchool::draw() const {
+	return m_sprite;
+}
+
+void SharkSchool::say(int i, std::ostream& os) const {
+	os << "Shark " << i;
+	switch (getInteract(i)) {
 	case Interact::ATTACK:
-		std::cout << getName() << ": OM NOM!";
+		os << ": OM NOM!";
 		break;
 	case Interact::ALONE:
-		std::cout << getName() << ": I'm hungry";
+		os << ": I'm hungry";
 		break;
 	case Interact::GREET:
-		std::cout << getName() << ": Hey Buddy";
+		os << ": Hey Buddy";
 		break;
 	default:
-		std::cout << getName() << ":A - hee - ahee ha - hee!";
+		os << ":A - hee - ahee ha - hee!";
 	}
-}
\ No newline at end of file
+}
@@ -1,13 +1,78 @@
 #ifndef SHARK_H
 #define SHARK_H
 #include"actor.h"
+#include"arraystack.h"
+#include<ostream>
+
 // Shark NPC's that roam the aquarium and bite at Nemo
-class Shark : public Actor {
+//
+// Sharks are not Actors, every shark would pay for a heap node, a
+// name string and a virtual update().  The school keeps them as a
+// structure of arrays instead, shark i is x[i], y[i], state[i] and
+// interact[i], and moves all of them in one loop.
+//
+// Directions come from a counter based hash of (seed, shark, step),
+// not a shared generator, so any batch of sharks can be moved in any
+// order, eight at a time with AVX2, and land in the same places.
+class ThreadPool;
+
+class SharkSchool {
 public:
-	Shark(Aquarium* aquarium, Point p, std::string name, char sprite);
-	virtual void update();	// Sharks move randomly in the world in search of prey
-	virtual void say();		// What does the shark say? 
+	SharkSchool();
+
+	int		add(Point p);		// Add a shark, returns its index
+	int		size() const;
+	void	reserve(int n);
+
+	// Sharks move randomly in the world in search of prey.  open is
+	// the aquarium's open cell mask, indexed by [y * cols + x], with
+	// at least SHARK_MASK_PAD readable bytes after the last cell.
+	// Uses the AVX2 kernel when the CPU has it, spread over pool's
+	// threads when given one.  Positions are the same either way.
+	void	update(const bool* open, int rows, int cols, ThreadPool* pool = nullptr);
+
+	// The two kernels behind update(), they move sharks identically
+	void	updateScalar(const bool* open, int rows, int cols);
+	void	updateAvx2(const bool* open, int rows, int cols);
+	static bool hasAvx2();
+
+	void	setSeed(unsigned seed);	// Also restarts the step count, 0 until set
+	unsigned getSeed() const;
+
+	Point	getPosition(int i) const;
+	int		x(int i) const;
+	int		y(int i) const;
+
+	State	getState(int i) const;
+	void	setInteract(int i, Interact interact);
+	Interact getInteract(int i) const;
+
+	char	draw() const;	// Every shark looks the same
+
+	// What does shark i say?  Its name is formatted here, only when
+	// something is listening
+	void	say(int i, std::ostream& os) const;
+
 private:
+	void	move(const bool* open, int rows, int cols, bool wide, ThreadPool* pool);
+
+	ArrayStack<int>	m_x;		// Positions after the last update
+	ArrayStack<int>	m_y;
+	ArrayStack<int>	m_nextX;	// Back buffer the next update writes
+	ArrayStack<int>	m_nextY;
+	ArrayStack<unsigned char> m_state;		// State, one byte each
+	ArrayStack<unsigned char> m_interact;	// Interact, one byte each
+
+	char	m_sprite;
+
+	unsigned m_seed;
+	unsigned m_step;		// Number of updates so far
 };
 
-#endif//SHARK_H
\ No newline at end of file
+// The AVX2 kernel reads the mask four bytes at a time
+const int SHARK_MASK_PAD = 3;
+
+// Sharks per parallel chunk, a multiple of the AVX2 width
+const int SHARK_GRAIN = 8192;
+
+#endif//SHARK_H
@@ -0,0 +1,91 @@
+#include"threadpool.h"
+
+ThreadPool::ThreadPool(int threads) :m_workers(nullptr), m_nWorkers(0), m_body(nullptr),
+	m_n(0), m_grain(1), m_next(0), m_generation(0), m_active(0), m_stop(false) {
+
+	if (threads <= 0)
+		threads = hardwareThreads();
+
+	m_nWorkers = threads - 1;
+	if (m_nWorkers > 0) {
+		m_workers = new std::thread[m_nWorkers];
+		for (int i = 0; i < m_nWorkers; i++)
+			m_workers[i] = std::thread(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	for (int i = 0; i < m_nWorkers; i++)
+		m_workers[i].join();
+	delete[] m_workers;
+}
+
+int ThreadPool::size() const {
+	return m_nWorkers + 1;
+}
+
+int ThreadPool::hardwareThreads() {
+	int n = (int)std::thread::hardware_concurrency();
+	return n > 0 ? n : 1;
+}
+
+void ThreadPool::parallelFor(int n, int grain, const std::function<void(int begin, int end)>& body) {
+	if (grain < 1)
+		grain = 1;
+	// Not worth waking anyone for a single chunk
+	if (m_nWorkers == 0 || n <= grain) {
+		if (n > 0)
+			body(0, n);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_body = &body;
+		m_n = n;
+		m_grain = grain;
+		m_next.store(0);
+		m_active = m_nWorkers;
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	runChunks();
+
+	std::unique_lock<std::mutex> lock(m_lock);
+	m_done.wait(lock, [this] { return m_active == 0; });
+	m_body = nullptr;
+}
+
+void ThreadPool::runChunks() {
+	for (;;) {
+		int begin = m_next.fetch_add(m_grain);
+		if (begin >= m_n)
+			return;
+		int end = m_n - begin < m_grain ? m_n : begin + m_grain;
+		(*m_body)(begin, end);
+	}
+}
+
+void ThreadPool::workerLoop() {
+	unsigned seen = 0;
+	std::unique_lock<std::mutex> lock(m_lock);
+	for (;;) {
+		m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+		if (m_stop)
+			return;
+		seen = m_generation;
+
+		lock.unlock();
+		runChunks();
+		lock.lock();
+
+		if (--m_active == 0)
+			m_done.notify_one();
+	}
+}
@@ -0,0 +1,56 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include<atomic>
+#include<condition_variable>
+#include<functional>
+#include<mutex>
+#include<thread>
+
+// Fixed set of worker threads for data parallel loops.
+//
+// parallelFor() hands out [0, n) in chunks of grain through one atomic
+// counter, the calling thread takes chunks too, and returns once every
+// chunk is done.  Workers sleep on a condition variable between loops.
+// Which thread runs a chunk is not fixed, so bodies must write only the
+// indices they were given.
+class ThreadPool {
+public:
+	// threads counts the caller, a pool of 1 runs everything inline.
+	// 0 means one per hardware thread.
+	explicit ThreadPool(int threads);
+	~ThreadPool();
+
+	int		size() const;	// Threads working a loop, caller included
+
+	void	parallelFor(int n, int grain, const std::function<void(int begin, int end)>& body);
+
+	static int hardwareThreads();
+
+private:
+	// Not copyable, owns its threads
+	ThreadPool(const ThreadPool& other);
+	ThreadPool& operator=(const ThreadPool& other);
+
+	void	workerLoop();
+	void	runChunks();
+
+	std::thread* m_workers;
+	int		m_nWorkers;
+
+	std::mutex	m_lock;
+	std::condition_variable m_wake;		// A new loop or shutdown
+	std::condition_variable m_done;		// Last worker left the loop
+
+	// The current loop, written under m_lock
+	const std::function<void(int, int)>* m_body;
+	int		m_n;
+	int		m_grain;
+	std::atomic<int> m_next;	// First index not handed out yet
+
+	unsigned m_generation;		// Bumped for every loop
+	int		m_active;			// Workers still in the current loop
+	bool	m_stop;
+};
+
+#endif//THREADPOOL_H
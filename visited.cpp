@@ -0,0 +1,69 @@
+#include"visited.h"
+#include<assert.h>
+#include<cstring>
+
+VisitedSet::VisitedSet() :
+	m_stamps(nullptr), m_epoch(1), m_rows(0), m_cols(0), m_count(0) {
+}
+
+VisitedSet::VisitedSet(int rows, int cols) :
+	m_stamps(nullptr), m_epoch(1), m_rows(0), m_cols(0), m_count(0) {
+	resize(rows, cols);
+}
+
+VisitedSet::~VisitedSet() {
+	delete[] m_stamps;
+}
+
+void VisitedSet::resize(int rows, int cols) {
+	delete[] m_stamps;
+	m_rows = rows;
+	m_cols = cols;
+	m_stamps = new unsigned[rows * cols];
+	memset(m_stamps, 0, rows * cols * sizeof(unsigned));
+	m_epoch = 1;
+	m_count = 0;
+}
+
+int VisitedSet::index(const Point& p) const {
+	assert(p.getX() >= 0 && p.getX() < m_cols);
+	assert(p.getY() >= 0 && p.getY() < m_rows);
+	return p.getY() * m_cols + p.getX();
+}
+
+bool VisitedSet::test(const Point& p) const {
+	return m_stamps[index(p)] == m_epoch;
+}
+
+void VisitedSet::set(const Point& p) {
+	testAndSet(p);
+}
+
+bool VisitedSet::testAndSet(const Point& p) {
+	unsigned& stamp = m_stamps[index(p)];
+	if (stamp == m_epoch)
+		return true;
+	stamp = m_epoch;
+	m_count++;
+	return false;
+}
+
+void VisitedSet::reset() {
+	m_count = 0;
+	// Stamps from 2^32 resets ago would look current again, so
+	// pay for one real clear when the counter wraps
+	if (++m_epoch == 0) {
+		memset(m_stamps, 0, m_rows * m_cols * sizeof(unsigned));
+		m_epoch = 1;
+	}
+}
+
+int VisitedSet::size() const {
+	return m_count;
+}
+int VisitedSet::rows() const {
+	return m_rows;
+}
+int VisitedSet::cols() const {
+	return m_cols;
+}
@@ -0,0 +1,50 @@
+#ifndef VISITED_H
+#define VISITED_H
+
+#include"point.h"
+
+// Set of visited cells on a rows x cols grid.
+//
+// Every cell stores the epoch it was last marked in, and a cell counts
+// as visited only if its stamp matches the current epoch.  That makes
+// test/set O(1), and reset() O(1) as well: it only bumps the epoch
+// instead of clearing every cell.  The stamps are cleared for real only
+// when the epoch counter wraps around.
+class VisitedSet {
+public:
+	VisitedSet();
+	VisitedSet(int rows, int cols);
+	~VisitedSet();
+
+	// Reallocate for a grid of the given size, forgets everything
+	void	resize(int rows, int cols);
+
+	// Note that the user must ensure p is inside the grid
+	bool	test(const Point& p) const;
+	void	set(const Point& p);
+
+	// Marks p and returns whether it was already visited
+	bool	testAndSet(const Point& p);
+
+	// Forget all visited cells
+	void	reset();
+
+	int		size() const;	// Number of cells visited this epoch
+	int		rows() const;
+	int		cols() const;
+
+private:
+	// Not copyable, the stamp array is owned
+	VisitedSet(const VisitedSet& other);
+	VisitedSet& operator=(const VisitedSet& other);
+
+	int		index(const Point& p) const;
+
+	unsigned*	m_stamps;	// Epoch each cell was last marked in
+	unsigned	m_epoch;	// Current epoch, never 0
+	int			m_rows;
+	int			m_cols;
+	int			m_count;
+};
+
+#endif//VISITED_H